@@ -7,7 +7,16 @@
 
 //#define TAPERED 1
 
+// Build with SINGLE_PRECISION=1 to tune in float, halving the memory traffic of the gradient and error passes
+#ifndef SINGLE_PRECISION
+#define SINGLE_PRECISION 0
+#endif
+
+#if SINGLE_PRECISION
+using tune_t = float;
+#else
 using tune_t = double;
+#endif
 
 #if TAPERED
 using pair_t = std::array<tune_t, 2>;
@@ -16,6 +25,33 @@ using parameters_t = std::vector<pair_t>;
 using parameters_t = std::vector<tune_t>;
 #endif
 
+// Values per parameter, midgame and endgame when tapered. Code written over phases with get_phase_value needs no TAPERED switch.
+#if TAPERED
+constexpr int32_t phase_count = 2;
+
+inline tune_t& get_phase_value(pair_t& parameter, const int32_t phase)
+{
+    return parameter[phase];
+}
+
+inline tune_t get_phase_value(const pair_t& parameter, const int32_t phase)
+{
+    return parameter[phase];
+}
+#else
+constexpr int32_t phase_count = 1;
+
+inline tune_t& get_phase_value(tune_t& parameter, int32_t)
+{
+    return parameter;
+}
+
+inline tune_t get_phase_value(const tune_t& parameter, int32_t)
+{
+    return parameter;
+}
+#endif
+
 using coefficients_t = std::vector<int16_t>;
 
 struct EvalResult
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Tunes the same data sources with the double and single precision builds, then compares throughput and final error.
+# Usage: ./benchmark_precision.sh [build directory] [sources.csv]
+set -e
+
+build_dir=${1:-build}
+sources=${2:-sources.csv}
+
+for binary in tuner tuner_single; do
+    if [ ! -x "$build_dir/$binary" ]; then
+        echo "$build_dir/$binary not found, build both the tuner and tuner_single targets first"
+        exit 1
+    fi
+done
+
+for binary in tuner tuner_single; do
+    echo "Running $binary..."
+    "$build_dir/$binary" "$sources" > "$binary.benchmark.log"
+done
+
+summary() {
+    grep "Finished .* epochs" "$1.benchmark.log" | sed 's/.*(\([0-9.e+-]*\) eps), final error \([0-9.e+-]*\).*/\1 \2/'
+}
+
+double_summary=$(summary tuner)
+single_summary=$(summary tuner_single)
+
+echo "$double_summary $single_summary" | awk '{
+    printf "double: %10.3f eps, final error %.10f\n", $1, $2
+    printf "single: %10.3f eps, final error %.10f\n", $3, $4
+    diff = $4 - $2
+    if (diff < 0) diff = -diff
+    printf "speedup %.3fx, final error difference %.3g\n", $3 / $1, diff
+}'
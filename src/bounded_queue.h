@@ -0,0 +1,72 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H 1
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+// Blocking producer/consumer queue holding at most `capacity` items
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(const size_t capacity) : capacity(capacity)
+    {
+    }
+
+    void push(T item)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            not_full_condition.wait(lock, [this]
+            {
+                return items.size() < capacity;
+            });
+            items.push(std::move(item));
+        }
+        not_empty_condition.notify_one();
+    }
+
+    // Returns nothing once the queue is closed and drained
+    std::optional<T> pop()
+    {
+        std::optional<T> item;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            not_empty_condition.wait(lock, [this]
+            {
+                return !items.empty() || closed;
+            });
+
+            if (items.empty())
+            {
+                return item;
+            }
+
+            item = std::move(items.front());
+            items.pop();
+        }
+        not_full_condition.notify_one();
+        return item;
+    }
+
+    void close()
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            closed = true;
+        }
+        not_empty_condition.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    bool closed = false;
+    std::mutex queue_mutex;
+    std::condition_variable not_empty_condition;
+    std::condition_variable not_full_condition;
+    std::queue<T> items;
+};
+
+#endif // !BOUNDED_QUEUE_H
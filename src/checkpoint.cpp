@@ -0,0 +1,268 @@
+#include "checkpoint.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Checkpoint;
+
+constexpr uint32_t checkpoint_version = 3;
+constexpr array<char, 8> checkpoint_magic = { 'T', 'X', 'L', 'C', 'H', 'K', 'P', 'T' };
+
+struct CheckpointHeader
+{
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t parameter_size;
+    uint64_t key;
+    int32_t epoch;
+    int32_t padding;
+    int64_t step_count;
+    tune_t learning_rate;
+    tune_t K;
+    tune_t beta1_power;
+    tune_t beta2_power;
+    uint64_t parameter_count;
+    uint64_t last_step_count;
+    uint64_t chunk_count;
+    uint64_t random_state_size;
+    tune_t best_validation_error;
+    int32_t best_validation_epoch;
+    int32_t validation_reports_since_best;
+    uint64_t best_parameter_count;
+};
+
+uint64_t Checkpoint::get_key(const uint64_t dataset_key, const size_t entry_count)
+{
+    uint64_t hash = dataset_key;
+    const auto add = [&hash](const uint64_t value)
+    {
+        hash ^= value;
+        hash *= 0x100000001b3ULL;
+    };
+
+    const auto add_real = [&add](const double value)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    };
+
+    add(checkpoint_version);
+    add(entry_count);
+    add(static_cast<uint64_t>(minibatch_size));
+    add(minibatch_seed);
+    add(sparse_adam);
+    add(collapse_duplicate_positions);
+    // A resumed run has to continue the same schedule, otherwise it mixes two optimizer configurations
+    add(static_cast<uint64_t>(TuneEval::max_epoch));
+    add_real(TuneEval::initial_learning_rate);
+    add(static_cast<uint64_t>(TuneEval::learning_rate_drop_interval));
+    add_real(TuneEval::learning_rate_drop_ratio);
+    add(TuneEval::adam_bias_correction);
+    return hash;
+}
+
+// Flushes the file's data to the disk, a rename of an unsynced file can survive a power loss while its contents don't
+static bool sync_file(const string& path)
+{
+#ifdef _WIN32
+    const auto handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    const bool synced = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return synced;
+#else
+    const int file_descriptor = open(path.c_str(), O_WRONLY);
+    if (file_descriptor < 0)
+    {
+        return false;
+    }
+    const bool synced = fsync(file_descriptor) == 0;
+    close(file_descriptor);
+    return synced;
+#endif
+}
+
+// Makes a rename into the directory durable. Windows has no directory handles to flush, NTFS journals the rename itself.
+static bool sync_directory(const string& path)
+{
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    auto directory = filesystem::path(path).parent_path();
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+    const int directory_descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory_descriptor < 0)
+    {
+        return false;
+    }
+    const bool synced = fsync(directory_descriptor) == 0;
+    close(directory_descriptor);
+    return synced;
+#endif
+}
+
+template<typename T>
+static bool read_vector(ifstream& file, vector<T>& values, const uint64_t count)
+{
+    values.resize(count);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<streamsize>(count * sizeof(T)));
+    return static_cast<bool>(file);
+}
+
+template<typename T>
+static void write_vector(ofstream& file, const vector<T>& values)
+{
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(T)));
+}
+
+bool Checkpoint::load(const string& path, const uint64_t key, State& state)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        cout << "Checkpoint " << path << " is truncated, ignoring" << endl;
+        return false;
+    }
+
+    if (header.magic != checkpoint_magic || header.version != checkpoint_version || header.parameter_size != sizeof(parameters_t::value_type))
+    {
+        cout << "Checkpoint " << path << " has an incompatible format, ignoring" << endl;
+        return false;
+    }
+
+    if (header.key != key)
+    {
+        cout << "Checkpoint " << path << " was written for a different dataset or settings, ignoring" << endl;
+        return false;
+    }
+
+    state.epoch = header.epoch;
+    state.step_count = header.step_count;
+    state.learning_rate = header.learning_rate;
+    state.K = header.K;
+    state.beta1_power = header.beta1_power;
+    state.beta2_power = header.beta2_power;
+    state.best_validation_error = header.best_validation_error;
+    state.best_validation_epoch = header.best_validation_epoch;
+    state.validation_reports_since_best = header.validation_reports_since_best;
+    state.random_state.resize(header.random_state_size);
+    if (!read_vector(file, state.parameters, header.parameter_count)
+        || !read_vector(file, state.momentum, header.parameter_count)
+        || !read_vector(file, state.velocity, header.parameter_count)
+        || !read_vector(file, state.last_steps, header.last_step_count)
+        || !read_vector(file, state.chunk_order, header.chunk_count)
+        || !file.read(state.random_state.data(), static_cast<streamsize>(header.random_state_size))
+        || !read_vector(file, state.best_parameters, header.best_parameter_count))
+    {
+        cout << "Checkpoint " << path << " is truncated, ignoring" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Checkpoint::save(const string& path, const uint64_t key, const State& state, ostream& log)
+{
+    CheckpointHeader header{};
+    header.magic = checkpoint_magic;
+    header.version = checkpoint_version;
+    header.parameter_size = sizeof(parameters_t::value_type);
+    header.key = key;
+    header.epoch = state.epoch;
+    header.step_count = state.step_count;
+    header.learning_rate = state.learning_rate;
+    header.K = state.K;
+    header.beta1_power = state.beta1_power;
+    header.beta2_power = state.beta2_power;
+    header.parameter_count = state.parameters.size();
+    header.last_step_count = state.last_steps.size();
+    header.chunk_count = state.chunk_order.size();
+    header.random_state_size = state.random_state.size();
+    header.best_validation_error = state.best_validation_error;
+    header.best_validation_epoch = state.best_validation_epoch;
+    header.validation_reports_since_best = state.validation_reports_since_best;
+    header.best_parameter_count = state.best_parameters.size();
+
+    // Same as the dataset cache, a crash while writing leaves the previous checkpoint in place.
+    // The new file is synced before the rename and the directory after it, so a power loss can't leave an empty or torn checkpoint.
+    const auto temp_path = path + ".tmp";
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+        {
+            log << "Failed to create checkpoint " << temp_path << endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_vector(file, state.parameters);
+        write_vector(file, state.momentum);
+        write_vector(file, state.velocity);
+        write_vector(file, state.last_steps);
+        write_vector(file, state.chunk_order);
+        file.write(state.random_state.data(), static_cast<streamsize>(state.random_state.size()));
+        write_vector(file, state.best_parameters);
+        file.flush();
+        if (!file)
+        {
+            log << "Failed to write checkpoint " << temp_path << endl;
+            return false;
+        }
+    }
+
+    if (!sync_file(temp_path))
+    {
+        log << "Failed to sync checkpoint " << temp_path << " to disk" << endl;
+        return false;
+    }
+
+    error_code error;
+    filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        log << "Failed to move checkpoint to " << path << ": " << error.message() << endl;
+        return false;
+    }
+
+    if (!sync_directory(path))
+    {
+        log << "Failed to sync the directory of checkpoint " << path << ", it may not survive a power loss" << endl;
+    }
+    return true;
+}
+
+void Checkpoint::remove(const string& path)
+{
+    error_code error;
+    filesystem::remove(path, error);
+    if (error)
+    {
+        cout << "Failed to remove finished checkpoint " << path << ": " << error.message() << endl;
+    }
+}
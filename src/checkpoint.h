@@ -0,0 +1,46 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H 1
+
+#include "config.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Checkpoint
+{
+    // Everything the Adam loop needs to continue where it stopped
+    struct State
+    {
+        int32_t epoch = 0;
+        int64_t step_count = 0;
+        tune_t learning_rate = 0;
+        tune_t K = 0;
+        tune_t beta1_power = 1;
+        tune_t beta2_power = 1;
+        parameters_t parameters;
+        parameters_t momentum;
+        parameters_t velocity;
+        std::vector<int64_t> last_steps;
+        // First entry of every chunk in the current order, mini-batch epochs keep shuffling it
+        std::vector<uint64_t> chunk_order;
+        std::string random_state;
+        tune_t best_validation_error = 0;
+        int32_t best_validation_epoch = 0;
+        int32_t validation_reports_since_best = 0;
+        // Empty until the validation error has been measured once
+        parameters_t best_parameters;
+    };
+
+    // Identifies the dataset and the optimizer settings that change what the saved state means
+    uint64_t get_key(uint64_t dataset_key, size_t entry_count);
+
+    bool load(const std::string& path, uint64_t key, State& state);
+    // Failures are written to log, the epoch loop passes a buffer it hands to the parameter reporter
+    bool save(const std::string& path, uint64_t key, const State& state, std::ostream& log);
+    // Called once training finishes, a later run with the same settings starts fresh instead of resuming at the end
+    void remove(const std::string& path);
+}
+
+#endif // !CHECKPOINT_H
@@ -15,6 +15,42 @@ constexpr int32_t data_load_thread_count = 4;
 constexpr int32_t thread_count = 12;
 constexpr static bool print_data_entries = false;
 constexpr static int32_t data_load_print_interval = 10000;
+constexpr static bool enable_dataset_cache = false;
+constexpr static auto dataset_cache_path = "dataset.cache";
+constexpr static bool enable_simd_kernels = true;
+constexpr static bool collapse_duplicate_positions = false;
+constexpr static int32_t error_print_interval = 100;
+constexpr static bool pin_threads = false;
+constexpr static int32_t pin_first_core = 0;
+constexpr static int32_t pin_core_stride = 1;
+constexpr static bool place_dataset_per_worker = false;
+constexpr static int64_t minibatch_size = 0;
+constexpr static uint64_t minibatch_seed = 1;
+constexpr static bool sparse_adam = false;
+constexpr static bool use_lbfgs = false;
+constexpr static int32_t lbfgs_history = 10;
+constexpr static int32_t lbfgs_line_search_steps = 8;
+constexpr static double lbfgs_tolerance = 1e-9;
+constexpr static bool least_squares_warm_start = false;
+constexpr static double warm_start_wdl_clip = 0.05;
+constexpr static double warm_start_ridge = 1e-4;
+constexpr static double warm_start_tolerance = 1e-4;
+constexpr static int32_t warm_start_max_iterations = 500;
+constexpr static bool enable_checkpoints = false;
+constexpr static auto checkpoint_path = "checkpoint.bin";
+constexpr static int32_t checkpoint_interval = 100;
+constexpr static double validation_fraction = 0;
+constexpr static uint64_t validation_seed = 1;
+constexpr static int32_t validation_patience = 0;
+constexpr static double validation_min_improvement = 1e-5;
+constexpr static int64_t k_sample_size = 0;
+constexpr static auto parameter_report_path = "";
+constexpr static bool column_major_gradient = false;
+constexpr static bool compress_coefficients = false;
+constexpr static double dense_coefficient_density = 0;
+static_assert(!column_major_gradient || (minibatch_size == 0 && !sparse_adam), "Column-major gradients need full batch dense steps");
+static_assert(!use_lbfgs || !enable_checkpoints, "Checkpoints only cover the Adam loop");
+static_assert(!use_lbfgs || minibatch_size == 0, "L-BFGS tunes on the full batch");
 
 
 #endif // !CONFIG_H
@@ -0,0 +1,576 @@
+#include "dataset.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+CoefficientValueTable coefficient_values;
+
+uint8_t CoefficientValueTable::get_code(const int16_t value)
+{
+    const auto assigned = value_codes[static_cast<uint16_t>(value)].load(memory_order_acquire);
+    if (assigned != 0)
+    {
+        return static_cast<uint8_t>(assigned - 1);
+    }
+    return assign_code(value);
+}
+
+uint8_t CoefficientValueTable::assign_code(const int16_t value)
+{
+    lock_guard<mutex> lock(assign_mutex);
+    auto& value_code = value_codes[static_cast<uint16_t>(value)];
+    const auto assigned = value_code.load(memory_order_relaxed);
+    if (assigned != 0)
+    {
+        return static_cast<uint8_t>(assigned - 1);
+    }
+
+    int32_t code = -1;
+    if (value >= INT8_MIN && value <= INT8_MAX && static_cast<uint8_t>(value) != coefficient_escape_code && !used_codes[static_cast<uint8_t>(value)])
+    {
+        code = static_cast<uint8_t>(value);
+    }
+    else
+    {
+        // Byte values of large magnitude are the least likely to show up later and want their own code.
+        // Code 0 stays zero, SIMD lanes past the end of an entry load it and must contribute nothing.
+        for (int32_t magnitude = INT8_MAX; magnitude > 0 && code < 0; magnitude--)
+        {
+            for (const auto candidate : { -magnitude, magnitude })
+            {
+                if (!used_codes[static_cast<uint8_t>(candidate)])
+                {
+                    code = static_cast<uint8_t>(candidate);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (code < 0)
+    {
+        used_codes[coefficient_escape_code] = 1;
+        escapes_used.store(true, memory_order_release);
+        code = coefficient_escape_code;
+    }
+    else
+    {
+        raw_values[code] = value;
+        values[code] = static_cast<tune_t>(value);
+        used_codes[code] = 1;
+    }
+    value_code.store(static_cast<uint16_t>(code + 1), memory_order_release);
+    return static_cast<uint8_t>(code);
+}
+
+void CoefficientValueTable::restore(const array<int16_t, coefficient_code_count>& saved_raw_values, const array<uint8_t, coefficient_code_count>& saved_used_codes)
+{
+    lock_guard<mutex> lock(assign_mutex);
+    for (auto& value_code : value_codes)
+    {
+        value_code.store(0, memory_order_relaxed);
+    }
+    raw_values = saved_raw_values;
+    used_codes = saved_used_codes;
+    escapes_used.store(used_codes[coefficient_escape_code] != 0, memory_order_release);
+    for (size_t code = 0; code < coefficient_code_count; code++)
+    {
+        values[code] = static_cast<tune_t>(raw_values[code]);
+        if (used_codes[code] && code != coefficient_escape_code)
+        {
+            value_codes[static_cast<uint16_t>(raw_values[code])].store(static_cast<uint16_t>(code + 1), memory_order_relaxed);
+        }
+    }
+}
+
+CoefficientEncoding CoefficientValueTable::get_encoding() const
+{
+    if (has_escapes())
+    {
+        return CoefficientEncoding::Escaped;
+    }
+    for (size_t code = 0; code < coefficient_code_count; code++)
+    {
+        if (used_codes[code] && raw_values[code] != static_cast<int8_t>(code))
+        {
+            return CoefficientEncoding::Table;
+        }
+    }
+    return CoefficientEncoding::Direct;
+}
+
+int32_t CoefficientValueTable::get_value_count() const
+{
+    int32_t count = 0;
+    for (size_t code = 0; code < coefficient_code_count; code++)
+    {
+        count += code != coefficient_escape_code && used_codes[code];
+    }
+    return count;
+}
+
+const char* get_coefficient_encoding_name(const CoefficientEncoding encoding)
+{
+    switch (encoding)
+    {
+    case CoefficientEncoding::Direct:
+        return "direct";
+    case CoefficientEncoding::Table:
+        return "table";
+    case CoefficientEncoding::Escaped:
+        return "escaped table";
+    }
+    return "unknown";
+}
+
+static uint64_t mix_hash(uint64_t hash, const uint64_t value)
+{
+    hash ^= value;
+    hash *= 0x9e3779b97f4a7c15ULL;
+    return hash ^ (hash >> 29);
+}
+
+static uint64_t get_run_hash(const CoefficientEntry* coefficients, const uint32_t count)
+{
+    uint64_t hash = mix_hash(0xcbf29ce484222325ULL, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t word;
+        memcpy(&word, &coefficients[i], sizeof(word));
+        hash = mix_hash(hash, word);
+    }
+    return hash;
+}
+
+uint32_t CoefficientDeduplicator::add(const CoefficientEntry* coefficients, const uint32_t count, vector<CoefficientEntry>& all_coefficients)
+{
+    const auto hash = get_run_hash(coefficients, count);
+    const auto existing = runs.find(hash);
+    if (existing != runs.end())
+    {
+        const auto& run = existing->second;
+        const auto* stored = all_coefficients.data() + run.offset;
+        if (run.count == count && memcmp(stored, coefficients, count * sizeof(CoefficientEntry)) == 0)
+        {
+            shared_count++;
+            return run.offset;
+        }
+
+        // Hash collision with a different run, store this one separately without tracking it
+        const auto offset = static_cast<uint32_t>(all_coefficients.size());
+        all_coefficients.insert(all_coefficients.end(), coefficients, coefficients + count);
+        return offset;
+    }
+
+    const auto offset = static_cast<uint32_t>(all_coefficients.size());
+    all_coefficients.insert(all_coefficients.end(), coefficients, coefficients + count);
+    runs.emplace(hash, Run{ offset, count });
+    return offset;
+}
+
+void compress_coefficient_run(vector<CoefficientEntry>& all_coefficients, const uint32_t offset, const uint16_t count)
+{
+    const vector<CoefficientEntry> coefficients(all_coefficients.begin() + offset, all_coefficients.begin() + offset + count);
+    vector<uint8_t> bytes;
+    bytes.reserve(count * 2 + count / coefficient_group_size + 1 + sizeof(CoefficientEntry));
+
+    uint32_t previous_index = 0;
+    for (uint32_t group_start = 0; group_start < count; group_start += coefficient_group_size)
+    {
+        const auto group_count = std::min(coefficient_group_size, count - group_start);
+        const auto control_position = bytes.size();
+        bytes.push_back(0);
+        for (uint32_t gi = 0; gi < group_count; gi++)
+        {
+            bytes.push_back(coefficients[group_start + gi].get_code());
+        }
+
+        uint8_t control = 0;
+        for (uint32_t gi = 0; gi < group_count; gi++)
+        {
+            const auto index = coefficients[group_start + gi].get_index();
+            if (gi + group_start > 0 && index <= previous_index)
+            {
+                throw runtime_error("Coefficient indices of an entry must ascend to be compressed");
+            }
+            const auto delta = index - previous_index;
+            previous_index = index;
+
+            const uint32_t length = delta < (1U << 8) ? 1 : delta < (1U << 16) ? 2 : 3;
+            control |= static_cast<uint8_t>((length - 1) << (2 * gi));
+            for (uint32_t byte_index = 0; byte_index < length; byte_index++)
+            {
+                bytes.push_back(static_cast<uint8_t>(delta >> (8 * byte_index)));
+            }
+        }
+        bytes[control_position] = control;
+    }
+
+    const auto slot_count = (bytes.size() + sizeof(CoefficientEntry) - 1) / sizeof(CoefficientEntry);
+    bytes.resize(slot_count * sizeof(CoefficientEntry), 0);
+    all_coefficients.resize(offset + slot_count);
+    memcpy(all_coefficients.data() + offset, bytes.data(), bytes.size());
+}
+
+void append_escaped_values(vector<CoefficientEntry>& all_coefficients, const vector<int16_t>& escaped_values)
+{
+    if (escaped_values.empty())
+    {
+        return;
+    }
+
+    const auto offset = all_coefficients.size();
+    const auto slot_count = (escaped_values.size() * sizeof(int16_t) + sizeof(CoefficientEntry) - 1) / sizeof(CoefficientEntry);
+    all_coefficients.resize(offset + slot_count);
+    memset(all_coefficients.data() + offset, 0, slot_count * sizeof(CoefficientEntry));
+    memcpy(all_coefficients.data() + offset, escaped_values.data(), escaped_values.size() * sizeof(int16_t));
+}
+
+// Slots of the run up to its escaped values
+static uint32_t get_coded_run_size(const CoefficientEntry* run, const uint16_t count)
+{
+    if constexpr (!compress_coefficients)
+    {
+        return dense_coefficients.slot_count + count;
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(run + dense_coefficients.slot_count);
+    size_t byte_count = 0;
+    for (uint32_t group_start = 0; group_start < count; group_start += coefficient_group_size)
+    {
+        const auto group_count = std::min(coefficient_group_size, count - group_start);
+        const auto control = bytes[byte_count];
+        byte_count += 1 + group_count;
+        for (uint32_t gi = 0; gi < group_count; gi++)
+        {
+            byte_count += ((control >> (2 * gi)) & 3) + 1;
+        }
+    }
+    return dense_coefficients.slot_count + static_cast<uint32_t>((byte_count + sizeof(CoefficientEntry) - 1) / sizeof(CoefficientEntry));
+}
+
+static uint32_t get_escaped_value_count(const CoefficientEntry* run, const uint16_t count)
+{
+    const auto* dense_codes = reinterpret_cast<const uint8_t*>(run);
+    uint32_t escaped_count = 0;
+    for (uint32_t di = 0; di < dense_coefficients.width; di++)
+    {
+        escaped_count += dense_codes[di] == coefficient_escape_code;
+    }
+
+    const auto* sparse = run + dense_coefficients.slot_count;
+    if constexpr (!compress_coefficients)
+    {
+        for (uint32_t ci = 0; ci < count; ci++)
+        {
+            escaped_count += sparse[ci].get_code() == coefficient_escape_code;
+        }
+    }
+    else
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(sparse);
+        for (uint32_t group_start = 0; group_start < count; group_start += coefficient_group_size)
+        {
+            const auto group_count = std::min(coefficient_group_size, count - group_start);
+            const auto control = bytes[0];
+            const auto* codes = bytes + 1;
+            bytes += 1 + group_count;
+            for (uint32_t gi = 0; gi < group_count; gi++)
+            {
+                escaped_count += codes[gi] == coefficient_escape_code;
+                bytes += ((control >> (2 * gi)) & 3) + 1;
+            }
+        }
+    }
+    return escaped_count;
+}
+
+uint32_t get_coefficient_run_size(const CoefficientEntry* run, const uint16_t count)
+{
+    const auto coded_size = get_coded_run_size(run, count);
+    if (!coefficient_values.has_escapes())
+    {
+        return coded_size;
+    }
+    const auto escaped_size = (get_escaped_value_count(run, count) * sizeof(int16_t) + sizeof(CoefficientEntry) - 1) / sizeof(CoefficientEntry);
+    return coded_size + static_cast<uint32_t>(escaped_size);
+}
+
+const uint8_t* get_escaped_values(const CoefficientEntry* run, const uint16_t count)
+{
+    return reinterpret_cast<const uint8_t*>(run + get_coded_run_size(run, count));
+}
+
+DenseCoefficientLayout dense_coefficients;
+
+DenseCoefficientLayout choose_dense_coefficients(const vector<Entry>& entries, const vector<CoefficientEntry>& all_coefficients, const size_t parameter_count, const double min_density)
+{
+    vector<size_t> entry_counts(parameter_count, 0);
+    for (const auto& entry : entries)
+    {
+        for_each_coefficient(entry, all_coefficients.data(), [&entry_counts](const CoefficientEntry coefficient, int16_t)
+        {
+            entry_counts[coefficient.get_index()]++;
+        });
+    }
+
+    DenseCoefficientLayout layout;
+    for (size_t parameter_index = 0; parameter_index < parameter_count; parameter_index++)
+    {
+        if (!entries.empty() && static_cast<double>(entry_counts[parameter_index]) >= min_density * static_cast<double>(entries.size()))
+        {
+            layout.parameter_indices.push_back(static_cast<uint32_t>(parameter_index));
+        }
+    }
+    const auto dense_count = static_cast<uint32_t>(layout.parameter_indices.size());
+    layout.width = (dense_count + dense_width_alignment - 1) / dense_width_alignment * dense_width_alignment;
+    layout.slot_count = layout.width / static_cast<uint32_t>(sizeof(CoefficientEntry));
+    return layout;
+}
+
+void split_dense_coefficients(vector<Entry>& entries, vector<CoefficientEntry>& all_coefficients, const DenseCoefficientLayout& layout)
+{
+    if (layout.width == 0)
+    {
+        return;
+    }
+
+    // Dense position of every parameter up to the last dense one, -1 for sparse parameters
+    vector<int32_t> dense_positions(layout.parameter_indices.back() + 1, -1);
+    for (size_t di = 0; di < layout.parameter_indices.size(); di++)
+    {
+        dense_positions[layout.parameter_indices[di]] = static_cast<int32_t>(di);
+    }
+
+    struct SplitRun
+    {
+        uint32_t offset;
+        uint16_t count;
+    };
+    unordered_map<uint32_t, SplitRun> split_runs;
+    vector<CoefficientEntry> split_coefficients;
+    vector<uint8_t> dense_codes(layout.width);
+    vector<int16_t> dense_values(layout.width);
+    vector<CoefficientEntry> sparse;
+    vector<int16_t> sparse_escaped_values;
+    vector<int16_t> escaped_values;
+    for (auto& entry : entries)
+    {
+        const auto existing = split_runs.find(entry.coeff_offset);
+        if (existing != split_runs.end())
+        {
+            entry.coeff_offset = existing->second.offset;
+            entry.coeff_count = existing->second.count;
+            continue;
+        }
+
+        std::fill(dense_codes.begin(), dense_codes.end(), static_cast<uint8_t>(0));
+        sparse.clear();
+        sparse_escaped_values.clear();
+        for_each_coefficient(entry, all_coefficients.data(), [&dense_positions, &dense_codes, &dense_values, &sparse, &sparse_escaped_values](const CoefficientEntry coefficient, const int16_t value)
+        {
+            const auto index = coefficient.get_index();
+            if (index < dense_positions.size() && dense_positions[index] >= 0)
+            {
+                dense_codes[dense_positions[index]] = coefficient.get_code();
+                dense_values[dense_positions[index]] = value;
+            }
+            else
+            {
+                sparse.push_back(coefficient);
+                if (coefficient.get_code() == coefficient_escape_code)
+                {
+                    sparse_escaped_values.push_back(value);
+                }
+            }
+        });
+
+        // The escaped values move with their codes, the dense block's now come first
+        escaped_values.clear();
+        for (uint32_t di = 0; di < layout.width; di++)
+        {
+            if (dense_codes[di] == coefficient_escape_code)
+            {
+                escaped_values.push_back(dense_values[di]);
+            }
+        }
+        escaped_values.insert(escaped_values.end(), sparse_escaped_values.begin(), sparse_escaped_values.end());
+
+        const auto offset = split_coefficients.size();
+        if (offset > UINT32_MAX)
+        {
+            throw runtime_error("Too many coefficients after adding dense blocks");
+        }
+        split_coefficients.resize(offset + layout.slot_count);
+        memcpy(split_coefficients.data() + offset, dense_codes.data(), layout.width);
+        split_coefficients.insert(split_coefficients.end(), sparse.begin(), sparse.end());
+        if constexpr (compress_coefficients)
+        {
+            compress_coefficient_run(split_coefficients, static_cast<uint32_t>(offset + layout.slot_count), static_cast<uint16_t>(sparse.size()));
+        }
+        append_escaped_values(split_coefficients, escaped_values);
+
+        const SplitRun split_run{ static_cast<uint32_t>(offset), static_cast<uint16_t>(sparse.size()) };
+        split_runs.emplace(entry.coeff_offset, split_run);
+        entry.coeff_offset = split_run.offset;
+        entry.coeff_count = split_run.count;
+    }
+
+    split_coefficients.shrink_to_fit();
+    all_coefficients.swap(split_coefficients);
+}
+
+// Coefficient runs are deduplicated when loading, so identical coefficients always share the same offset
+static uint64_t get_position_hash(const Entry& entry)
+{
+    uint32_t additional_score_bits;
+    memcpy(&additional_score_bits, &entry.additional_score, sizeof(additional_score_bits));
+
+    uint64_t hash = mix_hash(0xcbf29ce484222325ULL, entry.coeff_offset);
+    hash = mix_hash(hash, entry.coeff_count);
+    hash = mix_hash(hash, additional_score_bits);
+#if TAPERED
+    hash = mix_hash(hash, entry.phase);
+    hash = mix_hash(hash, entry.endgame_scale_fixed);
+#endif
+    return hash;
+}
+
+static bool is_same_position(const Entry& left, const Entry& right)
+{
+    return left.coeff_offset == right.coeff_offset
+        && left.coeff_count == right.coeff_count
+        && left.additional_score == right.additional_score
+#if TAPERED
+        && left.phase == right.phase
+        && left.endgame_scale_fixed == right.endgame_scale_fixed
+#endif
+        ;
+}
+
+int64_t collapse_duplicate_entries(vector<Entry>& entries)
+{
+    unordered_map<uint64_t, size_t> first_entries;
+    first_entries.reserve(entries.size());
+    vector<double> wdl_sums;
+    size_t collapsed_count = 0;
+
+    for (size_t entry_index = 0; entry_index < entries.size(); entry_index++)
+    {
+        const auto entry = entries[entry_index];
+        const auto hash = get_position_hash(entry);
+        const auto existing = first_entries.find(hash);
+        if (existing != first_entries.end())
+        {
+            auto& target = entries[existing->second];
+            if (is_same_position(target, entry) && target.weight + entry.weight <= UINT16_MAX)
+            {
+                target.weight += entry.weight;
+                wdl_sums[existing->second] += static_cast<double>(entry.get_wdl()) * entry.weight;
+                continue;
+            }
+        }
+
+        // Either a new position or a full weight, later duplicates are added to this entry from now on
+        entries[collapsed_count] = entry;
+        wdl_sums.push_back(static_cast<double>(entry.get_wdl()) * entry.weight);
+        first_entries.insert_or_assign(hash, collapsed_count);
+        collapsed_count++;
+    }
+
+    for (size_t entry_index = 0; entry_index < collapsed_count; entry_index++)
+    {
+        auto& entry = entries[entry_index];
+        if (entry.weight > 1)
+        {
+            entry.set_wdl(static_cast<tune_t>(wdl_sums[entry_index] / entry.weight));
+        }
+    }
+
+    const auto removed_count = static_cast<int64_t>(entries.size() - collapsed_count);
+    entries.resize(collapsed_count);
+    entries.shrink_to_fit();
+    return removed_count;
+}
+
+bool is_validation_position(const uint64_t position_hash)
+{
+    const auto hash = mix_hash(mix_hash(0xcbf29ce484222325ULL, validation_seed), position_hash);
+    return static_cast<double>(hash >> 11) * 0x1.0p-53 < validation_fraction;
+}
+
+void split_validation_entries(vector<Entry>& entries, const vector<EntryInfo>& entry_infos, const vector<CoefficientEntry>& all_coefficients, vector<Entry>& validation_entries, vector<CoefficientEntry>& validation_coefficients)
+{
+    unordered_map<uint32_t, uint32_t> validation_offsets;
+    size_t training_count = 0;
+    for (size_t entry_index = 0; entry_index < entries.size(); entry_index++)
+    {
+        if (entry_infos[entry_index].validation)
+        {
+            auto entry = entries[entry_index];
+            const auto [offset, inserted] = validation_offsets.try_emplace(entry.coeff_offset, static_cast<uint32_t>(validation_coefficients.size()));
+            if (inserted)
+            {
+                const auto* coefficients = all_coefficients.data() + entry.coeff_offset;
+                validation_coefficients.insert(validation_coefficients.end(), coefficients, coefficients + get_coefficient_run_size(coefficients, entry.coeff_count));
+            }
+            entry.coeff_offset = offset->second;
+            validation_entries.push_back(entry);
+        }
+        else
+        {
+            entries[training_count++] = entries[entry_index];
+        }
+    }
+    entries.resize(training_count);
+    entries.shrink_to_fit();
+}
+
+void CoefficientColumns::build(const vector<Entry>& entries, const vector<CoefficientEntry>& all_coefficients, const size_t parameter_count)
+{
+    if (entries.size() > UINT32_MAX)
+    {
+        throw runtime_error("Too many entries for a column index");
+    }
+
+    column_offsets.assign(parameter_count + 1, 0);
+    for (const auto& entry : entries)
+    {
+        for_each_coefficient(entry, all_coefficients.data(), [this](const CoefficientEntry coefficient, int16_t)
+        {
+            column_offsets[coefficient.get_index() + 1]++;
+        });
+    }
+    for (size_t parameter_index = 0; parameter_index < parameter_count; parameter_index++)
+    {
+        column_offsets[parameter_index + 1] += column_offsets[parameter_index];
+    }
+
+    entry_indices.resize(column_offsets[parameter_count]);
+    values.resize(column_offsets[parameter_count]);
+    vector<uint64_t> column_ends(column_offsets.begin(), column_offsets.end() - 1);
+    for (size_t entry_index = 0; entry_index < entries.size(); entry_index++)
+    {
+        for_each_coefficient(entries[entry_index], all_coefficients.data(), [this, &column_ends, entry_index](const CoefficientEntry coefficient, const int16_t value)
+        {
+            auto& position = column_ends[coefficient.get_index()];
+            entry_indices[position] = static_cast<uint32_t>(entry_index);
+            values[position] = value;
+            position++;
+        });
+    }
+}
+
+int64_t get_total_weight(const vector<Entry>& entries)
+{
+    int64_t total_weight = 0;
+    for (const auto& entry : entries)
+    {
+        total_weight += entry.weight;
+    }
+    return total_weight;
+}
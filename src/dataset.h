@@ -0,0 +1,369 @@
+#ifndef DATASET_H
+#define DATASET_H 1
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Parameter index in the high 24 bits and a value code in the low 8 bits, coefficient_values maps the code back to its value.
+// Default construction leaves the fields uninitialized, so a resized array is first touched by whichever thread fills it.
+struct CoefficientEntry
+{
+    uint32_t packed;
+
+    CoefficientEntry() {}
+    CoefficientEntry(const uint8_t code, const uint32_t index) : packed((index << 8) | code) {}
+
+    uint32_t get_index() const
+    {
+        return packed >> 8;
+    }
+
+    uint8_t get_code() const
+    {
+        return static_cast<uint8_t>(packed);
+    }
+};
+
+constexpr size_t max_coefficient_parameters = size_t(1) << 24;
+constexpr size_t coefficient_code_count = 256;
+// Stands for a value that got no code of its own, the raw value is stored after the entry's coefficients.
+// Its table value is 0, so a pass that doesn't look up the raw values leaves the coefficient out.
+constexpr uint8_t coefficient_escape_code = 0x80;
+
+enum class CoefficientEncoding
+{
+    // Every code is its value as a signed byte, kernels decode it with shifts alone
+    Direct,
+    // Some value lies outside the byte range, kernels look every code up in the value table
+    Table,
+    // Values that got no code are escaped, the scalar kernels look codes up and read escaped values in storage order
+    Escaped
+};
+
+// Assigns each distinct coefficient value of the dataset an 8-bit code. Values in the byte range get the code that
+// is their own bit pattern, so typical datasets need no lookups, outliers take the unused codes of the largest magnitudes.
+// Values seen after all 254 free codes are taken get coefficient_escape_code.
+class CoefficientValueTable
+{
+public:
+    // Thread-safe, returns the same code for a value every time
+    uint8_t get_code(int16_t value);
+    // Replaces the table with codes saved earlier by get_raw_values and get_used_codes
+    void restore(const std::array<int16_t, coefficient_code_count>& raw_values, const std::array<uint8_t, coefficient_code_count>& used_codes);
+
+    const tune_t* get_values() const
+    {
+        return values.data();
+    }
+
+    const std::array<int16_t, coefficient_code_count>& get_raw_values() const
+    {
+        return raw_values;
+    }
+
+    const std::array<uint8_t, coefficient_code_count>& get_used_codes() const
+    {
+        return used_codes;
+    }
+
+    // Safe while parsing, a run holding an escape code was coded after this turned true
+    bool has_escapes() const
+    {
+        return escapes_used.load(std::memory_order_acquire);
+    }
+
+    CoefficientEncoding get_encoding() const;
+    // Number of values with a code of their own
+    int32_t get_value_count() const;
+
+private:
+    // Code + 1 for every int16 value, 0 while the value has no code
+    std::array<std::atomic<uint16_t>, 65536> value_codes{};
+    std::mutex assign_mutex;
+    std::array<int16_t, coefficient_code_count> raw_values{};
+    std::array<tune_t, coefficient_code_count> values{};
+    // Also set for the escape code once some value had to be escaped, so saved tables keep that
+    std::array<uint8_t, coefficient_code_count> used_codes{};
+    std::atomic<bool> escapes_used{ false };
+
+    uint8_t assign_code(int16_t value);
+};
+
+extern CoefficientValueTable coefficient_values;
+
+const char* get_coefficient_encoding_name(CoefficientEncoding encoding);
+
+// WDL is stored in 1/60000 steps, exact for 1/3 and for probabilities with up to 4 decimals
+constexpr int32_t wdl_scale = 60000;
+// Endgame scale is stored in 1/128 steps in a byte, covering 0 to 255/128 (~1.99). Other scales are rounded to the
+// nearest step, 0.7 is tuned as 90/128 = 0.703. Evals with finer scales lose that precision, up to 1/256 per position.
+constexpr int32_t endgame_scale_scale = 128;
+
+// Everything a gradient or error pass reads per position, packed so each pass streams as few bytes as possible
+struct Entry
+{
+    uint32_t coeff_offset;
+    float additional_score;
+    uint16_t coeff_count;
+    uint16_t wdl_fixed;
+    // Number of identical positions this entry stands for, its wdl is their average
+    uint16_t weight;
+#if TAPERED
+    uint8_t phase;
+    uint8_t endgame_scale_fixed;
+#endif
+
+    // Leaves the fields uninitialized like CoefficientEntry
+    Entry() {}
+
+    // Eval of the position from the linear eval of each phase
+    tune_t blend_phases(const std::array<tune_t, phase_count>& phase_scores) const
+    {
+#if TAPERED
+        return (phase_scores[0] * phase + phase_scores[1] * get_endgame_scale() * (24 - phase)) / 24;
+#else
+        return phase_scores[0];
+#endif
+    }
+
+    tune_t get_wdl() const
+    {
+        return static_cast<tune_t>(wdl_fixed) / static_cast<tune_t>(wdl_scale);
+    }
+
+    static bool is_valid_wdl(const tune_t wdl)
+    {
+        return wdl >= 0 && wdl <= 1;
+    }
+
+    // Clamps instead of throwing, it runs in the parse workers. Lines with a WDL outside the range are rejected before it.
+    void set_wdl(const tune_t wdl)
+    {
+        const auto clamped = wdl >= 0 ? std::min(wdl, static_cast<tune_t>(1)) : static_cast<tune_t>(0);
+        wdl_fixed = static_cast<uint16_t>(std::lround(clamped * wdl_scale));
+    }
+
+#if TAPERED
+    tune_t get_endgame_scale() const
+    {
+        return static_cast<tune_t>(endgame_scale_fixed) / static_cast<tune_t>(endgame_scale_scale);
+    }
+
+    static bool is_valid_endgame_scale(const tune_t endgame_scale)
+    {
+        return endgame_scale >= 0 && endgame_scale * endgame_scale_scale < UINT8_MAX + static_cast<tune_t>(0.5);
+    }
+
+    // Clamps like set_wdl. Positions whose eval returns a scale outside the range are rejected, qsearch nodes are clamped.
+    void set_endgame_scale(const tune_t endgame_scale)
+    {
+        const auto scaled = endgame_scale >= 0 ? std::min(endgame_scale * endgame_scale_scale, static_cast<tune_t>(UINT8_MAX)) : static_cast<tune_t>(0);
+        endgame_scale_fixed = static_cast<uint8_t>(std::lround(scaled));
+    }
+#endif
+};
+
+static_assert(sizeof(Entry) == 16);
+static_assert(std::is_trivially_copyable_v<Entry> && std::is_trivially_copyable_v<CoefficientEntry>);
+
+// Parameters that are nonzero in nearly every entry, stored as a fixed-width block of value codes at the start of every run.
+// Code 0 is value 0, so a dense parameter missing from an entry costs one zero byte. The rest of the run holds the sparse coefficients.
+struct DenseCoefficientLayout
+{
+    // Dense parameters in block order, ascending
+    std::vector<uint32_t> parameter_indices;
+    // Codes per entry, padded with zero codes to a multiple of the widest SIMD lane count
+    uint32_t width = 0;
+    // CoefficientEntry slots the block takes up at the start of a run
+    uint32_t slot_count = 0;
+};
+
+constexpr uint32_t dense_width_alignment = 16;
+
+// Empty until split_dense_coefficients has moved the dense parameters out of the runs
+extern DenseCoefficientLayout dense_coefficients;
+
+// With compress_coefficients, the sparse part of an entry's run holds its coefficients in groups of 4: a control byte with the byte length
+// of each index delta in 2 bits, the 4 value codes, then the deltas. Indices ascend within an entry, so most deltas take one byte.
+// Runs are padded to whole CoefficientEntry slots, so offsets keep counting slots and the dataset can still hold 4G of them.
+constexpr uint32_t coefficient_group_size = 4;
+
+// Replaces the coefficients from offset to the end of all_coefficients with their compressed run
+void compress_coefficient_run(std::vector<CoefficientEntry>& all_coefficients, uint32_t offset, uint16_t count);
+// Appends the raw values of a run's escaped coefficients after it, two to a slot, dense block first and then in coefficient order
+void append_escaped_values(std::vector<CoefficientEntry>& all_coefficients, const std::vector<int16_t>& escaped_values);
+// Number of CoefficientEntry slots the run of an entry with count sparse coefficients takes up, dense block and escaped values included
+uint32_t get_coefficient_run_size(const CoefficientEntry* run, uint16_t count);
+// Start of the run's escaped values as stored by append_escaped_values, int16_t each
+const uint8_t* get_escaped_values(const CoefficientEntry* run, uint16_t count);
+
+// Calls body with every sparse coefficient of the entry in ascending index order, decoding the run if it is compressed
+template<typename Body>
+inline void for_each_sparse_coefficient(const Entry& entry, const CoefficientEntry* all_coefficients, Body&& body)
+{
+    const auto* run = all_coefficients + entry.coeff_offset + dense_coefficients.slot_count;
+    if constexpr (!compress_coefficients)
+    {
+        for (uint16_t ci = 0; ci < entry.coeff_count; ci++)
+        {
+            body(run[ci]);
+        }
+    }
+    else
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(run);
+        uint32_t index = 0;
+        for (uint32_t group_start = 0; group_start < entry.coeff_count; group_start += coefficient_group_size)
+        {
+            const auto group_count = std::min(coefficient_group_size, entry.coeff_count - group_start);
+            const auto control = bytes[0];
+            const auto* codes = bytes + 1;
+            bytes += 1 + group_count;
+            for (uint32_t gi = 0; gi < group_count; gi++)
+            {
+                const auto length = ((control >> (2 * gi)) & 3) + 1;
+                uint32_t delta = bytes[0];
+                if (length > 1)
+                {
+                    delta |= static_cast<uint32_t>(bytes[1]) << 8;
+                    if (length > 2)
+                    {
+                        delta |= static_cast<uint32_t>(bytes[2]) << 16;
+                    }
+                }
+                bytes += length;
+                index += delta;
+                body(CoefficientEntry(codes[gi], index));
+            }
+        }
+    }
+}
+
+inline const uint8_t* get_dense_codes(const Entry& entry, const CoefficientEntry* all_coefficients)
+{
+    return reinterpret_cast<const uint8_t*>(all_coefficients + entry.coeff_offset);
+}
+
+// Calls body with every nonzero coefficient of the entry and its value, the dense ones first
+template<typename Body>
+inline void for_each_coefficient(const Entry& entry, const CoefficientEntry* all_coefficients, Body&& body)
+{
+    const auto& raw_values = coefficient_values.get_raw_values();
+    const uint8_t* escaped_values = nullptr;
+    const auto visit = [&entry, all_coefficients, &body, &raw_values, &escaped_values](const CoefficientEntry coefficient)
+    {
+        const auto code = coefficient.get_code();
+        auto value = raw_values[code];
+        if (code == coefficient_escape_code)
+        {
+            if (escaped_values == nullptr)
+            {
+                escaped_values = get_escaped_values(all_coefficients + entry.coeff_offset, entry.coeff_count);
+            }
+            std::memcpy(&value, escaped_values, sizeof(value));
+            escaped_values += sizeof(value);
+        }
+        body(coefficient, value);
+    };
+
+    const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+    for (size_t di = 0; di < dense_coefficients.parameter_indices.size(); di++)
+    {
+        if (dense_codes[di] != 0)
+        {
+            visit(CoefficientEntry(dense_codes[di], dense_coefficients.parameter_indices[di]));
+        }
+    }
+    for_each_sparse_coefficient(entry, all_coefficients, visit);
+}
+
+// The entry's sparse coefficients as a plain array, decoded into buffer if the run is compressed.
+// Kernels that read the coefficients more than once decode them once this way.
+inline const CoefficientEntry* get_decoded_coefficients(const Entry& entry, const CoefficientEntry* all_coefficients, [[maybe_unused]] std::vector<CoefficientEntry>& buffer)
+{
+    if constexpr (!compress_coefficients)
+    {
+        return all_coefficients + entry.coeff_offset + dense_coefficients.slot_count;
+    }
+    else
+    {
+        if (buffer.size() < entry.coeff_count)
+        {
+            buffer.resize(entry.coeff_count);
+        }
+        auto* decoded = buffer.data();
+        for_each_sparse_coefficient(entry, all_coefficients, [&decoded](const CoefficientEntry coefficient)
+        {
+            *decoded++ = coefficient;
+        });
+        return buffer.data();
+    }
+}
+
+// Per-position data only used while preparing the dataset, kept apart from Entry so the passes over entries don't load it
+struct EntryInfo
+{
+    bool white_to_move;
+    bool validation;
+};
+
+// Decides from the position alone, so a position lands on the same side of the split in every run and every source
+bool is_validation_position(uint64_t position_hash);
+
+// Stores each distinct coefficient run once, so repeated positions and transpositions share their coefficients
+class CoefficientDeduplicator
+{
+public:
+    // Returns the offset of an identical run already in all_coefficients, or appends the run and returns its new offset
+    uint32_t add(const CoefficientEntry* coefficients, uint32_t count, std::vector<CoefficientEntry>& all_coefficients);
+    int64_t get_shared_count() const
+    {
+        return shared_count;
+    }
+
+private:
+    struct Run
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    std::unordered_map<uint64_t, Run> runs;
+    int64_t shared_count = 0;
+};
+
+// The coefficients of all entries grouped by parameter, each parameter's column lists the entries using it in entry order.
+// Unlike the per-entry runs, columns can't share storage between duplicate positions.
+struct CoefficientColumns
+{
+    std::vector<uint64_t> column_offsets;
+    std::vector<uint32_t> entry_indices;
+    std::vector<int16_t> values;
+
+    void build(const std::vector<Entry>& entries, const std::vector<CoefficientEntry>& all_coefficients, size_t parameter_count);
+};
+
+// Picks the parameters with a nonzero coefficient in at least min_density of the entries
+DenseCoefficientLayout choose_dense_coefficients(const std::vector<Entry>& entries, const std::vector<CoefficientEntry>& all_coefficients, size_t parameter_count, double min_density);
+// Rewrites every run as the layout's dense block followed by the remaining sparse coefficients, coeff_count becomes the sparse count.
+// Runs shared by several entries stay shared. Called for every set of entries before the layout is made current.
+void split_dense_coefficients(std::vector<Entry>& entries, std::vector<CoefficientEntry>& all_coefficients, const DenseCoefficientLayout& layout);
+
+// Merges entries that are identical apart from their wdl into one weighted entry, returns the number of entries removed
+int64_t collapse_duplicate_entries(std::vector<Entry>& entries);
+int64_t get_total_weight(const std::vector<Entry>& entries);
+// Moves the entries marked for validation out of entries, keeping the order of both.
+// Validation entries get their own copy of the coefficients they use, so the training coefficients can be rearranged freely.
+void split_validation_entries(std::vector<Entry>& entries, const std::vector<EntryInfo>& entry_infos, const std::vector<CoefficientEntry>& all_coefficients, std::vector<Entry>& validation_entries, std::vector<CoefficientEntry>& validation_coefficients);
+
+#endif // !DATASET_H
@@ -0,0 +1,205 @@
+#include "dataset_cache.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+
+using namespace std;
+using namespace DatasetCache;
+
+constexpr uint32_t cache_version = 6;
+constexpr array<char, 8> cache_magic = { 'T', 'X', 'L', 'C', 'A', 'C', 'H', 'E' };
+
+struct CacheHeader
+{
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t entry_size;
+    uint32_t info_size;
+    uint32_t coefficient_size;
+    uint32_t tune_size;
+    uint64_t key;
+    uint64_t entry_count;
+    uint64_t coefficient_count;
+    // The codes in the cached coefficients only mean something together with the value table they were assigned from
+    array<int16_t, coefficient_code_count> coefficient_values;
+    array<uint8_t, coefficient_code_count> coefficient_used_codes;
+};
+
+class KeyHasher
+{
+public:
+    void add_bytes(const void* data, const size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    template<typename T>
+    void add(const T& value)
+    {
+        add_bytes(&value, sizeof(value));
+    }
+
+    void add(const string& value)
+    {
+        add(value.size());
+        add_bytes(value.data(), value.size());
+    }
+
+    uint64_t get() const
+    {
+        return hash;
+    }
+
+private:
+    uint64_t hash = 0xcbf29ce484222325ULL;
+};
+
+uint64_t DatasetCache::get_key(const vector<Tuner::DataSource>& sources, const parameters_t& parameters)
+{
+    KeyHasher hasher;
+    hasher.add(cache_version);
+
+    for (const auto& source : sources)
+    {
+        hasher.add(source.path);
+        hasher.add(source.side_to_move_wdl);
+        hasher.add(source.position_limit);
+
+        // Source contents are not hashed, a changed size or modification time invalidates the cache instead
+        error_code error;
+        const auto file_size = filesystem::file_size(source.path, error);
+        hasher.add(error ? static_cast<uintmax_t>(0) : file_size);
+        const auto write_time = filesystem::last_write_time(source.path, error);
+        hasher.add(error ? static_cast<int64_t>(0) : static_cast<int64_t>(write_time.time_since_epoch().count()));
+    }
+
+    hasher.add(string(typeid(TuneEval).name()));
+    hasher.add(static_cast<int32_t>(TAPERED));
+    hasher.add(TuneEval::includes_additional_score);
+    hasher.add(TuneEval::supports_external_chess_eval);
+    hasher.add(TuneEval::enable_qsearch);
+    hasher.add(TuneEval::filter_in_check);
+    hasher.add(validation_fraction);
+    hasher.add(validation_seed);
+    hasher.add(compress_coefficients);
+
+    // Initial parameters drive qsearch and the additional score
+    hasher.add(parameters.size());
+    hasher.add_bytes(parameters.data(), parameters.size() * sizeof(parameters[0]));
+
+    return hasher.get();
+}
+
+template<typename T>
+static bool read_array(ifstream& file, vector<T>& values, const uint64_t count)
+{
+    values.resize(count);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<streamsize>(count * sizeof(T)));
+    return static_cast<bool>(file);
+}
+
+bool DatasetCache::load(const string& path, const uint64_t key, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients)
+{
+    // Read straight into the vectors, they are reordered and compacted after loading so they can't be views of a mapping
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    error_code error;
+    const auto file_size = filesystem::file_size(path, error);
+    CacheHeader header;
+    if (error || file_size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        cout << "Dataset cache " << path << " is truncated, ignoring" << endl;
+        return false;
+    }
+
+    if (header.magic != cache_magic || header.version != cache_version
+        || header.entry_size != sizeof(Entry) || header.info_size != sizeof(EntryInfo) || header.coefficient_size != sizeof(CoefficientEntry) || header.tune_size != sizeof(tune_t))
+    {
+        cout << "Dataset cache " << path << " has an incompatible format, ignoring" << endl;
+        return false;
+    }
+
+    if (header.key != key)
+    {
+        cout << "Dataset cache " << path << " was built from different sources or settings, ignoring" << endl;
+        return false;
+    }
+
+    const auto entries_bytes = header.entry_count * sizeof(Entry);
+    const auto infos_bytes = header.entry_count * sizeof(EntryInfo);
+    const auto coefficients_bytes = header.coefficient_count * sizeof(CoefficientEntry);
+    if (file_size != sizeof(header) + entries_bytes + infos_bytes + coefficients_bytes)
+    {
+        cout << "Dataset cache " << path << " is truncated, ignoring" << endl;
+        return false;
+    }
+
+    if (!read_array(file, entries, header.entry_count) || !read_array(file, entry_infos, header.entry_count) || !read_array(file, all_coefficients, header.coefficient_count))
+    {
+        cout << "Failed to read dataset cache " << path << ", ignoring" << endl;
+        entries.clear();
+        entry_infos.clear();
+        all_coefficients.clear();
+        return false;
+    }
+    coefficient_values.restore(header.coefficient_values, header.coefficient_used_codes);
+
+    return true;
+}
+
+void DatasetCache::save(const string& path, const uint64_t key, const vector<Entry>& entries, const vector<EntryInfo>& entry_infos, const vector<CoefficientEntry>& all_coefficients)
+{
+    CacheHeader header{};
+    header.magic = cache_magic;
+    header.version = cache_version;
+    header.entry_size = sizeof(Entry);
+    header.info_size = sizeof(EntryInfo);
+    header.coefficient_size = sizeof(CoefficientEntry);
+    header.tune_size = sizeof(tune_t);
+    header.key = key;
+    header.entry_count = entries.size();
+    header.coefficient_count = all_coefficients.size();
+    header.coefficient_values = coefficient_values.get_raw_values();
+    header.coefficient_used_codes = coefficient_values.get_used_codes();
+
+    // Write to a temporary file and rename, so an interrupted save never leaves a valid-looking cache behind
+    const auto temp_path = path + ".tmp";
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cout << "Failed to create dataset cache " << temp_path << endl;
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<streamsize>(entries.size() * sizeof(Entry)));
+        file.write(reinterpret_cast<const char*>(entry_infos.data()), static_cast<streamsize>(entry_infos.size() * sizeof(EntryInfo)));
+        file.write(reinterpret_cast<const char*>(all_coefficients.data()), static_cast<streamsize>(all_coefficients.size() * sizeof(CoefficientEntry)));
+        if (!file)
+        {
+            cout << "Failed to write dataset cache " << temp_path << endl;
+            return;
+        }
+    }
+
+    error_code error;
+    filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        cout << "Failed to move dataset cache to " << path << ": " << error.message() << endl;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef DATASET_CACHE_H
+#define DATASET_CACHE_H 1
+
+#include "dataset.h"
+#include "tuner.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DatasetCache
+{
+    // Identifies everything that affects the parsed entries: data sources, eval class, parameters and load settings
+    uint64_t get_key(const std::vector<Tuner::DataSource>& sources, const parameters_t& parameters);
+
+    bool load(const std::string& path, uint64_t key, std::vector<Entry>& entries, std::vector<EntryInfo>& entry_infos, std::vector<CoefficientEntry>& all_coefficients);
+    void save(const std::string& path, uint64_t key, const std::vector<Entry>& entries, const std::vector<EntryInfo>& entry_infos, const std::vector<CoefficientEntry>& all_coefficients);
+}
+
+#endif // !DATASET_CACHE_H
@@ -27,6 +27,7 @@ namespace Fourkdotcpp
         constexpr static bool adam_bias_correction = false;
         constexpr static bool print_data_entries = false;
         constexpr static int32_t data_load_print_interval = 10000;
+        constexpr static size_t parameter_count = 148;
 
         static parameters_t get_initial_parameters();
         static EvalResult get_fen_eval_result(const std::string& fen);
@@ -0,0 +1,146 @@
+#include "fen_line.h"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+
+using namespace std;
+
+struct WdlMarker
+{
+    string_view marker;
+    tune_t wdl;
+};
+
+static constexpr array<WdlMarker, 4> markers
+{
+    WdlMarker{"1.0", 1},
+
+    WdlMarker{"1-0", 1},
+    WdlMarker{"1/2-1/2", 0.5},
+    WdlMarker{"0-1", 0}
+};
+
+static bool is_separator(const char ch)
+{
+    return ch == ' ' || ch == '\t';
+}
+
+static bool parse_probability(const string_view word, tune_t& wdl)
+{
+    string_view number;
+    if (word.starts_with("0."))
+    {
+        number = word;
+    }
+    else if (word.starts_with("[0."))
+    {
+        number = word.substr(1);
+    }
+    else
+    {
+        return false;
+    }
+
+    // Parses the longest valid prefix, so trailing brackets or separators are ignored
+    tune_t value = 0;
+    from_chars(number.data(), number.data() + number.size(), value);
+    wdl = value;
+    return true;
+}
+
+FenLineStatus parse_fen_line(const string_view line, FenLine& fen_line)
+{
+    // The four position fields are separated by single spaces and followed by at least one more
+    array<string_view, 4> fields;
+    size_t field_start = 0;
+    for (auto& field : fields)
+    {
+        const auto space = line.find(' ', field_start);
+        if (space == string_view::npos)
+        {
+            return FenLineStatus::MissingFields;
+        }
+        field = line.substr(field_start, space - field_start);
+        field_start = space + 1;
+    }
+
+    fen_line.position = line.substr(0, field_start - 1);
+    fen_line.board = fields[0];
+    fen_line.side_to_move = fields[1];
+    fen_line.castling = fields[2];
+    fen_line.en_passant = fields[3];
+    fen_line.white_to_move = fields[1].empty() || fields[1][0] == 'w';
+
+    // Move counters and the result follow in any order, a result marker anywhere in a word takes precedence over a probability
+    uint32_t found_markers = 0;
+    tune_t marker_wdl = 0;
+    bool probability_found = false;
+    tune_t probability = 0;
+    size_t word_start = field_start;
+    while (word_start < line.size())
+    {
+        if (is_separator(line[word_start]))
+        {
+            word_start++;
+            continue;
+        }
+
+        auto word_end = word_start;
+        while (word_end < line.size() && !is_separator(line[word_end]))
+        {
+            word_end++;
+        }
+        const auto word = line.substr(word_start, word_end - word_start);
+        word_start = word_end;
+
+        for (uint32_t marker_index = 0; marker_index < markers.size(); marker_index++)
+        {
+            if (word.find(markers[marker_index].marker) != string_view::npos)
+            {
+                found_markers |= 1U << marker_index;
+                marker_wdl = markers[marker_index].wdl;
+            }
+        }
+
+        probability_found |= parse_probability(word, probability);
+    }
+
+    if (found_markers != 0)
+    {
+        if ((found_markers & (found_markers - 1)) != 0)
+        {
+            return FenLineStatus::WdlAmbiguous;
+        }
+        fen_line.wdl = marker_wdl;
+        return FenLineStatus::Ok;
+    }
+
+    if (probability_found)
+    {
+        fen_line.wdl = probability;
+        return FenLineStatus::Ok;
+    }
+
+    return FenLineStatus::WdlNotFound;
+}
+
+const char* get_fen_line_status_description(const FenLineStatus status)
+{
+    switch (status)
+    {
+    case FenLineStatus::Ok:
+        return "ok";
+    case FenLineStatus::MissingFields:
+        return "FEN is missing fields";
+    case FenLineStatus::WdlNotFound:
+        return "WDL marker not found";
+    case FenLineStatus::WdlAmbiguous:
+        return "multiple WDL markers found";
+    case FenLineStatus::WdlOutOfRange:
+        return "WDL outside 0 to 1";
+    case FenLineStatus::EndgameScaleOutOfRange:
+        return "endgame scale outside 0 to 255/128";
+    }
+    return "unknown error";
+}
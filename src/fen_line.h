@@ -0,0 +1,36 @@
+#ifndef FEN_LINE_H
+#define FEN_LINE_H 1
+
+#include "config.h"
+
+#include <string_view>
+
+enum class FenLineStatus
+{
+    Ok,
+    MissingFields,
+    WdlNotFound,
+    WdlAmbiguous,
+    // A probability outside 0 to 1
+    WdlOutOfRange,
+    // The eval returned an endgame scale that Entry can't store
+    EndgameScaleOutOfRange
+};
+
+// Views into a data source line, valid for as long as the line itself
+struct FenLine
+{
+    // Board, side to move, castling and en passant fields, without move counters or result
+    std::string_view position;
+    std::string_view board;
+    std::string_view side_to_move;
+    std::string_view castling;
+    std::string_view en_passant;
+    bool white_to_move;
+    tune_t wdl;
+};
+
+FenLineStatus parse_fen_line(std::string_view line, FenLine& fen_line);
+const char* get_fen_line_status_description(FenLineStatus status);
+
+#endif // !FEN_LINE_H
@@ -0,0 +1,1007 @@
+#include "gradient_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define X86_KERNELS 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+#else
+#define X86_KERNELS 0
+#endif
+
+using namespace std;
+
+// Entries evaluated together before their gradients are scattered, so the gathers of independent entries overlap
+constexpr size_t kernel_batch_size = 4;
+
+void SplitParameters::resize(const size_t size)
+{
+    midgame.resize(size);
+#if TAPERED
+    endgame.resize(size);
+#endif
+}
+
+void SplitParameters::zero()
+{
+    std::fill(midgame.begin(), midgame.end(), static_cast<tune_t>(0));
+#if TAPERED
+    std::fill(endgame.begin(), endgame.end(), static_cast<tune_t>(0));
+#endif
+}
+
+void SplitParameters::assign(const parameters_t& parameters)
+{
+    resize(parameters.size());
+    for (size_t parameter_index = 0; parameter_index < parameters.size(); parameter_index++)
+    {
+#if TAPERED
+        midgame[parameter_index] = parameters[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)];
+        endgame[parameter_index] = parameters[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)];
+#else
+        midgame[parameter_index] = parameters[parameter_index];
+#endif
+    }
+}
+
+void SplitParameters::add(const SplitParameters& other)
+{
+    for (size_t parameter_index = 0; parameter_index < midgame.size(); parameter_index++)
+    {
+        midgame[parameter_index] += other.midgame[parameter_index];
+#if TAPERED
+        endgame[parameter_index] += other.endgame[parameter_index];
+#endif
+    }
+}
+
+void SplitParameters::add_to(parameters_t& parameters) const
+{
+    for (size_t parameter_index = 0; parameter_index < parameters.size(); parameter_index++)
+    {
+#if TAPERED
+        parameters[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)] += midgame[parameter_index];
+        parameters[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)] += endgame[parameter_index];
+#else
+        parameters[parameter_index] += midgame[parameter_index];
+#endif
+    }
+}
+
+void SplitParameters::zero(const vector<uint32_t>& indices)
+{
+    for (const auto parameter_index : indices)
+    {
+        midgame[parameter_index] = 0;
+#if TAPERED
+        endgame[parameter_index] = 0;
+#endif
+    }
+}
+
+void SplitParameters::assign(const parameters_t& parameters, const vector<uint32_t>& indices)
+{
+    for (const auto parameter_index : indices)
+    {
+#if TAPERED
+        midgame[parameter_index] = parameters[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)];
+        endgame[parameter_index] = parameters[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)];
+#else
+        midgame[parameter_index] = parameters[parameter_index];
+#endif
+    }
+}
+
+void SplitParameters::add_to(parameters_t& parameters, const vector<uint32_t>& indices) const
+{
+    for (const auto parameter_index : indices)
+    {
+#if TAPERED
+        parameters[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)] += midgame[parameter_index];
+        parameters[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)] += endgame[parameter_index];
+#else
+        parameters[parameter_index] += midgame[parameter_index];
+#endif
+    }
+}
+
+void PairwiseGradientSum::reset(const size_t parameter_count)
+{
+    count = 0;
+    for (auto& level : levels)
+    {
+        level.resize(parameter_count);
+    }
+}
+
+void PairwiseGradientSum::add(SplitParameters& block)
+{
+    size_t level = 0;
+    for (auto pending = count; pending & 1; pending >>= 1)
+    {
+        block.add(levels[level]);
+        level++;
+    }
+
+    if (level == levels.size())
+    {
+        levels.emplace_back();
+        levels.back().resize(block.midgame.size());
+    }
+    std::swap(levels[level], block);
+    count++;
+}
+
+void PairwiseGradientSum::get_total(SplitParameters& total) const
+{
+    total.zero();
+    for (size_t level = 0; level < levels.size(); level++)
+    {
+        if ((count >> level) & 1)
+        {
+            total.add(levels[level]);
+        }
+    }
+}
+
+// Splits the sigmoid derivative of an entry into the factors its midgame and endgame coefficients are scaled with, and adds the entry's squared error
+static EntryResidual get_entry_residual(const Entry& entry, const tune_t score, const tune_t K, tune_t& error)
+{
+    const tune_t sig = sigmoid(K, score);
+    const tune_t diff = entry.get_wdl() - sig;
+    error += diff * diff * entry.weight;
+    const tune_t res = diff * sig * (1 - sig) * entry.weight;
+
+    EntryResidual residual;
+#if TAPERED
+    residual.midgame = res * (entry.phase / static_cast<tune_t>(24));
+    residual.endgame = (res - residual.midgame) * entry.get_endgame_scale();
+#else
+    residual.midgame = res;
+#endif
+    return residual;
+}
+
+static tune_t get_entry_score(const Entry& entry, const tune_t midgame, [[maybe_unused]] const tune_t endgame)
+{
+#if TAPERED
+    return entry.additional_score + (midgame * entry.phase + endgame * entry.get_endgame_scale() * (24 - entry.phase)) / 24;
+#else
+    return entry.additional_score + midgame;
+#endif
+}
+
+// Direct codes are the value's own bits, table codes are looked up
+template<CoefficientEncoding Encoding>
+static tune_t decode_value(const uint8_t code, const tune_t* value_table)
+{
+    if constexpr (Encoding == CoefficientEncoding::Direct)
+    {
+        return static_cast<int8_t>(code);
+    }
+    else
+    {
+        return value_table[code];
+    }
+}
+
+// Decodes the codes of one entry in storage order, dense block first. Escaped codes take the entry's escaped values one after another,
+// so each value gets the same product and place in the sums whether it has a code of its own or not.
+template<CoefficientEncoding Encoding>
+class EntryValueDecoder
+{
+public:
+    EntryValueDecoder(const Entry& entry, const CoefficientEntry* all_coefficients, const tune_t* value_table) : value_table(value_table)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Escaped)
+        {
+            escaped_values = get_escaped_values(all_coefficients + entry.coeff_offset, entry.coeff_count);
+        }
+    }
+
+    tune_t operator()(const uint8_t code)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Escaped)
+        {
+            if (code == coefficient_escape_code)
+            {
+                int16_t value;
+                memcpy(&value, escaped_values, sizeof(value));
+                escaped_values += sizeof(value);
+                return value;
+            }
+        }
+        return decode_value<Encoding>(code, value_table);
+    }
+
+private:
+    const tune_t* value_table;
+    const uint8_t* escaped_values = nullptr;
+};
+
+// The dense parameters gathered into contiguous arrays for one kernel call, so the dense block of every entry is a plain dot product.
+// Zero past the dense parameter count, padded codes add nothing. Their gradient is summed here and added to the full gradient once per call.
+struct DenseParameters
+{
+    uint32_t width;
+    vector<tune_t> midgame;
+    vector<tune_t> midgame_gradient;
+#if TAPERED
+    vector<tune_t> endgame;
+    vector<tune_t> endgame_gradient;
+#endif
+
+    explicit DenseParameters(const SplitParameters& parameters) : width(dense_coefficients.width)
+    {
+        const auto& indices = dense_coefficients.parameter_indices;
+        midgame.assign(width, 0);
+        midgame_gradient.assign(width, 0);
+#if TAPERED
+        endgame.assign(width, 0);
+        endgame_gradient.assign(width, 0);
+#endif
+        for (size_t di = 0; di < indices.size(); di++)
+        {
+            midgame[di] = parameters.midgame[indices[di]];
+#if TAPERED
+            endgame[di] = parameters.endgame[indices[di]];
+#endif
+        }
+    }
+
+    void add_gradient_to(SplitParameters& gradient) const
+    {
+        const auto& indices = dense_coefficients.parameter_indices;
+        for (size_t di = 0; di < indices.size(); di++)
+        {
+            gradient.midgame[indices[di]] += midgame_gradient[di];
+#if TAPERED
+            gradient.endgame[indices[di]] += endgame_gradient[di];
+#endif
+        }
+    }
+};
+
+template<CoefficientEncoding Encoding>
+static tune_t accumulate_gradient_scalar(const Entry* entries, const size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, SplitParameters& gradient, const tune_t K)
+{
+    const tune_t* value_table = coefficient_values.get_values();
+    const tune_t* midgame_parameters = parameters.midgame.data();
+    tune_t* midgame_gradient = gradient.midgame.data();
+#if TAPERED
+    const tune_t* endgame_parameters = parameters.endgame.data();
+    tune_t* endgame_gradient = gradient.endgame.data();
+#endif
+    tune_t error = 0;
+    vector<CoefficientEntry> decoded;
+    DenseParameters dense(parameters);
+
+    for (size_t entry_index = 0; entry_index < entry_count; entry_index++)
+    {
+        const auto& entry = entries[entry_index];
+        const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+        const auto* coefficients = get_decoded_coefficients(entry, all_coefficients, decoded);
+        const auto count = entry.coeff_count;
+        const EntryValueDecoder<Encoding> entry_decoder(entry, all_coefficients, value_table);
+
+        // First pass: compute linear eval
+        auto decode = entry_decoder;
+        tune_t midgame = 0;
+        tune_t endgame = 0;
+        for (uint32_t di = 0; di < dense.width; di++)
+        {
+            const auto value = decode(dense_codes[di]);
+            midgame += value * dense.midgame[di];
+#if TAPERED
+            endgame += value * dense.endgame[di];
+#endif
+        }
+        for (uint16_t ci = 0; ci < count; ci++)
+        {
+            const auto index = coefficients[ci].get_index();
+            const auto value = decode(coefficients[ci].get_code());
+            midgame += value * midgame_parameters[index];
+#if TAPERED
+            endgame += value * endgame_parameters[index];
+#endif
+        }
+
+        // Second pass: accumulate gradient (coefficients still in L1)
+        const auto residual = get_entry_residual(entry, get_entry_score(entry, midgame, endgame), K, error);
+        decode = entry_decoder;
+        for (uint32_t di = 0; di < dense.width; di++)
+        {
+            const auto value = decode(dense_codes[di]);
+            dense.midgame_gradient[di] += residual.midgame * value;
+#if TAPERED
+            dense.endgame_gradient[di] += residual.endgame * value;
+#endif
+        }
+        for (uint16_t ci = 0; ci < count; ci++)
+        {
+            const auto index = coefficients[ci].get_index();
+            const auto value = decode(coefficients[ci].get_code());
+            midgame_gradient[index] += residual.midgame * value;
+#if TAPERED
+            endgame_gradient[index] += residual.endgame * value;
+#endif
+        }
+    }
+    dense.add_gradient_to(gradient);
+    return error;
+}
+
+template<CoefficientEncoding Encoding>
+static tune_t compute_entry_residuals_encoded(const Entry* entries, const size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, EntryResidual* residuals, const tune_t K)
+{
+    const tune_t* value_table = coefficient_values.get_values();
+    const tune_t* midgame_parameters = parameters.midgame.data();
+#if TAPERED
+    const tune_t* endgame_parameters = parameters.endgame.data();
+#endif
+    tune_t error = 0;
+    vector<CoefficientEntry> decoded;
+    const DenseParameters dense(parameters);
+
+    for (size_t entry_index = 0; entry_index < entry_count; entry_index++)
+    {
+        const auto& entry = entries[entry_index];
+        const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+        const auto* coefficients = get_decoded_coefficients(entry, all_coefficients, decoded);
+        EntryValueDecoder<Encoding> decode(entry, all_coefficients, value_table);
+        tune_t midgame = 0;
+        tune_t endgame = 0;
+        for (uint32_t di = 0; di < dense.width; di++)
+        {
+            const auto value = decode(dense_codes[di]);
+            midgame += value * dense.midgame[di];
+#if TAPERED
+            endgame += value * dense.endgame[di];
+#endif
+        }
+        for (uint16_t ci = 0; ci < entry.coeff_count; ci++)
+        {
+            const auto index = coefficients[ci].get_index();
+            const auto value = decode(coefficients[ci].get_code());
+            midgame += value * midgame_parameters[index];
+#if TAPERED
+            endgame += value * endgame_parameters[index];
+#endif
+        }
+        residuals[entry_index] = get_entry_residual(entry, get_entry_score(entry, midgame, endgame), K, error);
+    }
+    return error;
+}
+
+tune_t compute_entry_residuals(const Entry* entries, const size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, EntryResidual* residuals, const tune_t K, const CoefficientEncoding encoding)
+{
+    if (encoding == CoefficientEncoding::Direct)
+    {
+        return compute_entry_residuals_encoded<CoefficientEncoding::Direct>(entries, entry_count, all_coefficients, parameters, residuals, K);
+    }
+    if (encoding == CoefficientEncoding::Escaped)
+    {
+        return compute_entry_residuals_encoded<CoefficientEncoding::Escaped>(entries, entry_count, all_coefficients, parameters, residuals, K);
+    }
+    return compute_entry_residuals_encoded<CoefficientEncoding::Table>(entries, entry_count, all_coefficients, parameters, residuals, K);
+}
+
+#if X86_KERNELS
+
+// Coefficient entries are loaded as packed 32-bit lanes, the value code in the low byte and the index in the high 24 bits
+static_assert(sizeof(CoefficientEntry) == 4 && offsetof(CoefficientEntry, packed) == 0);
+
+template<typename T>
+struct Avx2Lanes;
+
+template<>
+struct Avx2Lanes<double>
+{
+    using vector_t = __m256d;
+    using packed_t = __m128i;
+    static constexpr uint32_t count = 4;
+
+    // Lanes past the end load as zero, so they gather parameter 0 and contribute nothing
+    TARGET_AVX2 static packed_t load(const int32_t* coefficients, const uint32_t remaining)
+    {
+        if (remaining >= count)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(coefficients));
+        }
+        const __m128i mask = _mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int32_t>(remaining)));
+        return _mm_maskload_epi32(coefficients, mask);
+    }
+
+    TARGET_AVX2 static packed_t indices(const packed_t packed)
+    {
+        return _mm_srli_epi32(packed, 8);
+    }
+
+    template<CoefficientEncoding Encoding>
+    TARGET_AVX2 static vector_t values(const packed_t packed, const double* value_table)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Direct)
+        {
+            return _mm256_cvtepi32_pd(_mm_srai_epi32(_mm_slli_epi32(packed, 24), 24));
+        }
+        else
+        {
+            return gather(value_table, _mm_and_si128(packed, _mm_set1_epi32(0xFF)));
+        }
+    }
+
+    TARGET_AVX2 static vector_t gather(const double* base, const packed_t indices)
+    {
+        return _mm256_i32gather_pd(base, indices, 8);
+    }
+
+    // Dense block codes widened to the low byte of each lane, so values decodes them like packed coefficients
+    TARGET_AVX2 static packed_t load_codes(const uint8_t* codes)
+    {
+        int32_t bytes;
+        memcpy(&bytes, codes, sizeof(bytes));
+        return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+    }
+
+    TARGET_AVX2 static vector_t load(const double* values)
+    {
+        return _mm256_loadu_pd(values);
+    }
+
+    TARGET_AVX2 static void store(double* values, const vector_t value)
+    {
+        _mm256_storeu_pd(values, value);
+    }
+
+    TARGET_AVX2 static vector_t broadcast(const double value)
+    {
+        return _mm256_set1_pd(value);
+    }
+
+    TARGET_AVX2 static vector_t zero()
+    {
+        return _mm256_setzero_pd();
+    }
+
+    TARGET_AVX2 static vector_t fmadd(const vector_t a, const vector_t b, const vector_t c)
+    {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+
+    TARGET_AVX2 static double sum(const vector_t value)
+    {
+        const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    }
+};
+
+template<>
+struct Avx2Lanes<float>
+{
+    using vector_t = __m256;
+    using packed_t = __m256i;
+    static constexpr uint32_t count = 8;
+
+    TARGET_AVX2 static packed_t load(const int32_t* coefficients, const uint32_t remaining)
+    {
+        if (remaining >= count)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(coefficients));
+        }
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(remaining)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        return _mm256_maskload_epi32(coefficients, mask);
+    }
+
+    TARGET_AVX2 static packed_t indices(const packed_t packed)
+    {
+        return _mm256_srli_epi32(packed, 8);
+    }
+
+    template<CoefficientEncoding Encoding>
+    TARGET_AVX2 static vector_t values(const packed_t packed, const float* value_table)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Direct)
+        {
+            return _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 24), 24));
+        }
+        else
+        {
+            return gather(value_table, _mm256_and_si256(packed, _mm256_set1_epi32(0xFF)));
+        }
+    }
+
+    TARGET_AVX2 static vector_t gather(const float* base, const packed_t indices)
+    {
+        return _mm256_i32gather_ps(base, indices, 4);
+    }
+
+    TARGET_AVX2 static packed_t load_codes(const uint8_t* codes)
+    {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes)));
+    }
+
+    TARGET_AVX2 static vector_t load(const float* values)
+    {
+        return _mm256_loadu_ps(values);
+    }
+
+    TARGET_AVX2 static void store(float* values, const vector_t value)
+    {
+        _mm256_storeu_ps(values, value);
+    }
+
+    TARGET_AVX2 static vector_t broadcast(const float value)
+    {
+        return _mm256_set1_ps(value);
+    }
+
+    TARGET_AVX2 static vector_t zero()
+    {
+        return _mm256_setzero_ps();
+    }
+
+    TARGET_AVX2 static vector_t fmadd(const vector_t a, const vector_t b, const vector_t c)
+    {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    TARGET_AVX2 static float sum(const vector_t value)
+    {
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        return _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+    }
+};
+
+template<typename T>
+struct Avx512Lanes;
+
+template<>
+struct Avx512Lanes<double>
+{
+    using vector_t = __m512d;
+    using packed_t = __m256i;
+    using mask_t = __mmask8;
+    static constexpr uint32_t count = 8;
+
+    TARGET_AVX512 static mask_t get_mask(const uint32_t remaining)
+    {
+        return remaining >= count ? static_cast<mask_t>(0xFF) : static_cast<mask_t>((1U << remaining) - 1);
+    }
+
+    TARGET_AVX512 static packed_t load(const int32_t* coefficients, const mask_t mask)
+    {
+        return _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(static_cast<__mmask16>(mask), coefficients));
+    }
+
+    TARGET_AVX512 static packed_t indices(const packed_t packed)
+    {
+        return _mm256_srli_epi32(packed, 8);
+    }
+
+    template<CoefficientEncoding Encoding>
+    TARGET_AVX512 static vector_t values(const packed_t packed, const mask_t mask, const double* value_table)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Direct)
+        {
+            return _mm512_cvtepi32_pd(_mm256_srai_epi32(_mm256_slli_epi32(packed, 24), 24));
+        }
+        else
+        {
+            return gather(value_table, _mm256_and_si256(packed, _mm256_set1_epi32(0xFF)), mask);
+        }
+    }
+
+    TARGET_AVX512 static vector_t gather(const double* base, const packed_t indices, const mask_t mask)
+    {
+        return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, indices, base, 8);
+    }
+
+    TARGET_AVX512 static void scatter(double* base, const packed_t indices, const mask_t mask, const vector_t value)
+    {
+        _mm512_mask_i32scatter_pd(base, mask, indices, value, 8);
+    }
+
+    TARGET_AVX512 static packed_t load_codes(const uint8_t* codes)
+    {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes)));
+    }
+
+    TARGET_AVX512 static vector_t load(const double* values)
+    {
+        return _mm512_loadu_pd(values);
+    }
+
+    TARGET_AVX512 static void store(double* values, const vector_t value)
+    {
+        _mm512_storeu_pd(values, value);
+    }
+
+    TARGET_AVX512 static vector_t broadcast(const double value)
+    {
+        return _mm512_set1_pd(value);
+    }
+
+    TARGET_AVX512 static vector_t zero()
+    {
+        return _mm512_setzero_pd();
+    }
+
+    TARGET_AVX512 static vector_t fmadd(const vector_t a, const vector_t b, const vector_t c)
+    {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+
+    TARGET_AVX512 static double sum(const vector_t value)
+    {
+        return _mm512_reduce_add_pd(value);
+    }
+};
+
+template<>
+struct Avx512Lanes<float>
+{
+    using vector_t = __m512;
+    using packed_t = __m512i;
+    using mask_t = __mmask16;
+    static constexpr uint32_t count = 16;
+
+    TARGET_AVX512 static mask_t get_mask(const uint32_t remaining)
+    {
+        return remaining >= count ? static_cast<mask_t>(0xFFFF) : static_cast<mask_t>((1U << remaining) - 1);
+    }
+
+    TARGET_AVX512 static packed_t load(const int32_t* coefficients, const mask_t mask)
+    {
+        return _mm512_maskz_loadu_epi32(mask, coefficients);
+    }
+
+    TARGET_AVX512 static packed_t indices(const packed_t packed)
+    {
+        return _mm512_srli_epi32(packed, 8);
+    }
+
+    template<CoefficientEncoding Encoding>
+    TARGET_AVX512 static vector_t values(const packed_t packed, const mask_t mask, const float* value_table)
+    {
+        if constexpr (Encoding == CoefficientEncoding::Direct)
+        {
+            return _mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(packed, 24), 24));
+        }
+        else
+        {
+            return gather(value_table, _mm512_and_si512(packed, _mm512_set1_epi32(0xFF)), mask);
+        }
+    }
+
+    TARGET_AVX512 static vector_t gather(const float* base, const packed_t indices, const mask_t mask)
+    {
+        return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, indices, base, 4);
+    }
+
+    TARGET_AVX512 static void scatter(float* base, const packed_t indices, const mask_t mask, const vector_t value)
+    {
+        _mm512_mask_i32scatter_ps(base, mask, indices, value, 4);
+    }
+
+    TARGET_AVX512 static packed_t load_codes(const uint8_t* codes)
+    {
+        return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(codes)));
+    }
+
+    TARGET_AVX512 static vector_t load(const float* values)
+    {
+        return _mm512_loadu_ps(values);
+    }
+
+    TARGET_AVX512 static void store(float* values, const vector_t value)
+    {
+        _mm512_storeu_ps(values, value);
+    }
+
+    TARGET_AVX512 static vector_t broadcast(const float value)
+    {
+        return _mm512_set1_ps(value);
+    }
+
+    TARGET_AVX512 static vector_t zero()
+    {
+        return _mm512_setzero_ps();
+    }
+
+    TARGET_AVX512 static vector_t fmadd(const vector_t a, const vector_t b, const vector_t c)
+    {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+
+    TARGET_AVX512 static float sum(const vector_t value)
+    {
+        return _mm512_reduce_add_ps(value);
+    }
+};
+
+template<typename Lanes, CoefficientEncoding Encoding>
+TARGET_AVX2 static tune_t accumulate_gradient_avx2(const Entry* entries, const size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, SplitParameters& gradient, const tune_t K)
+{
+    const tune_t* value_table = coefficient_values.get_values();
+    const tune_t* midgame_parameters = parameters.midgame.data();
+    tune_t* midgame_gradient = gradient.midgame.data();
+#if TAPERED
+    const tune_t* endgame_parameters = parameters.endgame.data();
+    tune_t* endgame_gradient = gradient.endgame.data();
+#endif
+    tune_t error = 0;
+    array<vector<CoefficientEntry>, kernel_batch_size> decoded;
+    DenseParameters dense(parameters);
+
+    for (size_t batch_start = 0; batch_start < entry_count; batch_start += kernel_batch_size)
+    {
+        const auto batch_count = std::min(kernel_batch_size, entry_count - batch_start);
+        array<EntryResidual, kernel_batch_size> residuals;
+        array<const CoefficientEntry*, kernel_batch_size> batch_coefficients;
+
+        for (size_t batch_index = 0; batch_index < batch_count; batch_index++)
+        {
+            const auto& entry = entries[batch_start + batch_index];
+            batch_coefficients[batch_index] = get_decoded_coefficients(entry, all_coefficients, decoded[batch_index]);
+            const auto* coefficients = reinterpret_cast<const int32_t*>(batch_coefficients[batch_index]);
+            const uint32_t count = entry.coeff_count;
+
+            auto midgame = Lanes::zero();
+            auto endgame = Lanes::zero();
+            const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+            for (uint32_t di = 0; di < dense.width; di += Lanes::count)
+            {
+                const auto values = Lanes::template values<Encoding>(Lanes::load_codes(dense_codes + di), value_table);
+                midgame = Lanes::fmadd(values, Lanes::load(dense.midgame.data() + di), midgame);
+#if TAPERED
+                endgame = Lanes::fmadd(values, Lanes::load(dense.endgame.data() + di), endgame);
+#endif
+            }
+            for (uint32_t ci = 0; ci < count; ci += Lanes::count)
+            {
+                const auto packed = Lanes::load(coefficients + ci, count - ci);
+                const auto values = Lanes::template values<Encoding>(packed, value_table);
+                const auto indices = Lanes::indices(packed);
+                midgame = Lanes::fmadd(values, Lanes::gather(midgame_parameters, indices), midgame);
+#if TAPERED
+                endgame = Lanes::fmadd(values, Lanes::gather(endgame_parameters, indices), endgame);
+#endif
+            }
+
+            const auto score = get_entry_score(entry, Lanes::sum(midgame), Lanes::sum(endgame));
+            residuals[batch_index] = get_entry_residual(entry, score, K, error);
+        }
+
+        // AVX2 has no scatter, indices are unique within an entry so each lane is written back on its own
+        for (size_t batch_index = 0; batch_index < batch_count; batch_index++)
+        {
+            const auto& entry = entries[batch_start + batch_index];
+            const auto* coefficients = batch_coefficients[batch_index];
+            const auto& residual = residuals[batch_index];
+
+            const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+            const auto midgame_residual = Lanes::broadcast(residual.midgame);
+#if TAPERED
+            const auto endgame_residual = Lanes::broadcast(residual.endgame);
+#endif
+            for (uint32_t di = 0; di < dense.width; di += Lanes::count)
+            {
+                const auto values = Lanes::template values<Encoding>(Lanes::load_codes(dense_codes + di), value_table);
+                Lanes::store(dense.midgame_gradient.data() + di, Lanes::fmadd(values, midgame_residual, Lanes::load(dense.midgame_gradient.data() + di)));
+#if TAPERED
+                Lanes::store(dense.endgame_gradient.data() + di, Lanes::fmadd(values, endgame_residual, Lanes::load(dense.endgame_gradient.data() + di)));
+#endif
+            }
+
+            for (uint16_t ci = 0; ci < entry.coeff_count; ci++)
+            {
+                const auto index = coefficients[ci].get_index();
+                const auto value = decode_value<Encoding>(coefficients[ci].get_code(), value_table);
+                midgame_gradient[index] += residual.midgame * value;
+#if TAPERED
+                endgame_gradient[index] += residual.endgame * value;
+#endif
+            }
+        }
+    }
+    dense.add_gradient_to(gradient);
+    return error;
+}
+
+template<typename Lanes, CoefficientEncoding Encoding>
+TARGET_AVX512 static tune_t accumulate_gradient_avx512(const Entry* entries, const size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, SplitParameters& gradient, const tune_t K)
+{
+    const tune_t* value_table = coefficient_values.get_values();
+    const tune_t* midgame_parameters = parameters.midgame.data();
+    tune_t* midgame_gradient = gradient.midgame.data();
+#if TAPERED
+    const tune_t* endgame_parameters = parameters.endgame.data();
+    tune_t* endgame_gradient = gradient.endgame.data();
+#endif
+    tune_t error = 0;
+    array<vector<CoefficientEntry>, kernel_batch_size> decoded;
+    DenseParameters dense(parameters);
+    const auto full_mask = Lanes::get_mask(Lanes::count);
+
+    for (size_t batch_start = 0; batch_start < entry_count; batch_start += kernel_batch_size)
+    {
+        const auto batch_count = std::min(kernel_batch_size, entry_count - batch_start);
+        array<EntryResidual, kernel_batch_size> residuals;
+        array<const CoefficientEntry*, kernel_batch_size> batch_coefficients;
+
+        for (size_t batch_index = 0; batch_index < batch_count; batch_index++)
+        {
+            const auto& entry = entries[batch_start + batch_index];
+            batch_coefficients[batch_index] = get_decoded_coefficients(entry, all_coefficients, decoded[batch_index]);
+            const auto* coefficients = reinterpret_cast<const int32_t*>(batch_coefficients[batch_index]);
+            const uint32_t count = entry.coeff_count;
+
+            auto midgame = Lanes::zero();
+            auto endgame = Lanes::zero();
+            const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+            for (uint32_t di = 0; di < dense.width; di += Lanes::count)
+            {
+                const auto values = Lanes::template values<Encoding>(Lanes::load_codes(dense_codes + di), full_mask, value_table);
+                midgame = Lanes::fmadd(values, Lanes::load(dense.midgame.data() + di), midgame);
+#if TAPERED
+                endgame = Lanes::fmadd(values, Lanes::load(dense.endgame.data() + di), endgame);
+#endif
+            }
+            for (uint32_t ci = 0; ci < count; ci += Lanes::count)
+            {
+                const auto mask = Lanes::get_mask(count - ci);
+                const auto packed = Lanes::load(coefficients + ci, mask);
+                const auto values = Lanes::template values<Encoding>(packed, mask, value_table);
+                const auto indices = Lanes::indices(packed);
+                midgame = Lanes::fmadd(values, Lanes::gather(midgame_parameters, indices, mask), midgame);
+#if TAPERED
+                endgame = Lanes::fmadd(values, Lanes::gather(endgame_parameters, indices, mask), endgame);
+#endif
+            }
+
+            const auto score = get_entry_score(entry, Lanes::sum(midgame), Lanes::sum(endgame));
+            residuals[batch_index] = get_entry_residual(entry, score, K, error);
+        }
+
+        // Indices are unique within an entry, so a gather, add and scatter never loses an update
+        for (size_t batch_index = 0; batch_index < batch_count; batch_index++)
+        {
+            const auto& entry = entries[batch_start + batch_index];
+            const auto* coefficients = reinterpret_cast<const int32_t*>(batch_coefficients[batch_index]);
+            const uint32_t count = entry.coeff_count;
+            const auto midgame_residual = Lanes::broadcast(residuals[batch_index].midgame);
+#if TAPERED
+            const auto endgame_residual = Lanes::broadcast(residuals[batch_index].endgame);
+#endif
+            const auto* dense_codes = get_dense_codes(entry, all_coefficients);
+            for (uint32_t di = 0; di < dense.width; di += Lanes::count)
+            {
+                const auto values = Lanes::template values<Encoding>(Lanes::load_codes(dense_codes + di), full_mask, value_table);
+                Lanes::store(dense.midgame_gradient.data() + di, Lanes::fmadd(values, midgame_residual, Lanes::load(dense.midgame_gradient.data() + di)));
+#if TAPERED
+                Lanes::store(dense.endgame_gradient.data() + di, Lanes::fmadd(values, endgame_residual, Lanes::load(dense.endgame_gradient.data() + di)));
+#endif
+            }
+            for (uint32_t ci = 0; ci < count; ci += Lanes::count)
+            {
+                const auto mask = Lanes::get_mask(count - ci);
+                const auto packed = Lanes::load(coefficients + ci, mask);
+                const auto values = Lanes::template values<Encoding>(packed, mask, value_table);
+                const auto indices = Lanes::indices(packed);
+
+                const auto midgame = Lanes::gather(midgame_gradient, indices, mask);
+                Lanes::scatter(midgame_gradient, indices, mask, Lanes::fmadd(values, midgame_residual, midgame));
+#if TAPERED
+                const auto endgame = Lanes::gather(endgame_gradient, indices, mask);
+                Lanes::scatter(endgame_gradient, indices, mask, Lanes::fmadd(values, endgame_residual, endgame));
+#endif
+            }
+        }
+    }
+    dense.add_gradient_to(gradient);
+    return error;
+}
+
+#endif
+
+KernelIsa detect_kernel_isa()
+{
+#if X86_KERNELS
+#if defined(_MSC_VER) && !defined(__clang__)
+    array<int, 4> info{};
+    __cpuid(info.data(), 0);
+    const auto max_leaf = info[0];
+    if (max_leaf < 7)
+    {
+        return KernelIsa::Scalar;
+    }
+
+    __cpuid(info.data(), 1);
+    const bool has_fma = (info[2] & (1 << 12)) != 0;
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    if (!has_osxsave)
+    {
+        return KernelIsa::Scalar;
+    }
+
+    // The OS has to save the AVX and AVX-512 register state on context switches
+    const auto xcr0 = _xgetbv(0);
+    __cpuidex(info.data(), 7, 0);
+    const bool has_avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    const bool has_avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+#else
+    __builtin_cpu_init();
+    const bool has_fma = __builtin_cpu_supports("fma");
+    const bool has_avx2 = __builtin_cpu_supports("avx2");
+    const bool has_avx512 = __builtin_cpu_supports("avx512f");
+#endif
+
+    if (has_avx512 && has_avx2 && has_fma)
+    {
+        return KernelIsa::Avx512;
+    }
+    if (has_avx2 && has_fma)
+    {
+        return KernelIsa::Avx2;
+    }
+#endif
+
+    return KernelIsa::Scalar;
+}
+
+const char* get_kernel_isa_name(const KernelIsa isa)
+{
+    switch (isa)
+    {
+    case KernelIsa::Scalar:
+        return "scalar";
+    case KernelIsa::Avx2:
+        return "AVX2";
+    case KernelIsa::Avx512:
+        return "AVX-512";
+    }
+    return "unknown";
+}
+
+template<CoefficientEncoding Encoding>
+static GradientKernel get_encoded_gradient_kernel(const KernelIsa isa)
+{
+    switch (isa)
+    {
+#if X86_KERNELS
+    case KernelIsa::Avx2:
+        return accumulate_gradient_avx2<Avx2Lanes<tune_t>, Encoding>;
+    case KernelIsa::Avx512:
+        return accumulate_gradient_avx512<Avx512Lanes<tune_t>, Encoding>;
+#endif
+    default:
+        return accumulate_gradient_scalar<Encoding>;
+    }
+}
+
+GradientKernel get_gradient_kernel(const KernelIsa isa, const CoefficientEncoding encoding)
+{
+    if (encoding == CoefficientEncoding::Direct)
+    {
+        return get_encoded_gradient_kernel<CoefficientEncoding::Direct>(isa);
+    }
+    if (encoding == CoefficientEncoding::Escaped)
+    {
+        // Escaped values are read in order as the codes are met, which the SIMD kernels' lane loads don't do
+        return accumulate_gradient_scalar<CoefficientEncoding::Escaped>;
+    }
+    return get_encoded_gradient_kernel<CoefficientEncoding::Table>(isa);
+}
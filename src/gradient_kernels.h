@@ -0,0 +1,76 @@
+#ifndef GRADIENT_KERNELS_H
+#define GRADIENT_KERNELS_H 1
+
+#include "dataset.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+inline tune_t sigmoid(const tune_t K, const tune_t eval)
+{
+    return static_cast<tune_t>(1) / (static_cast<tune_t>(1) + std::exp(-K * eval / static_cast<tune_t>(400)));
+}
+
+// Parameters with the midgame and endgame values in separate arrays, so a kernel can gather one phase per instruction
+struct SplitParameters
+{
+    std::vector<tune_t> midgame;
+#if TAPERED
+    std::vector<tune_t> endgame;
+#endif
+
+    void resize(size_t size);
+    void zero();
+    void assign(const parameters_t& parameters);
+    void add(const SplitParameters& other);
+    void add_to(parameters_t& parameters) const;
+    // Same as the above, restricted to the given parameter indices
+    void zero(const std::vector<uint32_t>& indices);
+    void assign(const parameters_t& parameters, const std::vector<uint32_t>& indices);
+    void add_to(parameters_t& parameters, const std::vector<uint32_t>& indices) const;
+};
+
+// Pairwise sum of per-block gradients, so single precision gradients lose accuracy with log(blocks) instead of the entry count
+class PairwiseGradientSum
+{
+public:
+    void reset(size_t parameter_count);
+    // Takes over the block's storage, the block is left with arbitrary contents
+    void add(SplitParameters& block);
+    void get_total(SplitParameters& total) const;
+
+private:
+    uint64_t count = 0;
+    std::vector<SplitParameters> levels;
+};
+
+// Factors an entry's midgame and endgame coefficients are multiplied with to get its gradient contribution
+struct EntryResidual
+{
+    tune_t midgame;
+#if TAPERED
+    tune_t endgame;
+#endif
+};
+
+enum class KernelIsa
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+// Accumulates the unscaled loss gradient of a contiguous range of entries and returns their weighted squared error, which the pass gets for the cost of one multiply-add per entry
+using GradientKernel = tune_t(*)(const Entry* entries, size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, SplitParameters& gradient, tune_t K);
+
+KernelIsa detect_kernel_isa();
+const char* get_kernel_isa_name(KernelIsa isa);
+// The kernel for the instruction set, specialized for how the dataset encodes its coefficient values
+GradientKernel get_gradient_kernel(KernelIsa isa, CoefficientEncoding encoding);
+
+// Stores each entry's residual instead of adding its gradient, for gradients summed per parameter afterwards. Returns the weighted squared error.
+tune_t compute_entry_residuals(const Entry* entries, size_t entry_count, const CoefficientEntry* all_coefficients, const SplitParameters& parameters, EntryResidual* residuals, tune_t K, CoefficientEncoding encoding);
+
+#endif // !GRADIENT_KERNELS_H
@@ -0,0 +1,135 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const string& path)
+{
+    close();
+
+#ifdef _WIN32
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        file_handle = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size))
+    {
+        close();
+        return false;
+    }
+    mapped_size = static_cast<size_t>(file_size.QuadPart);
+
+    if (mapped_size > 0)
+    {
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_handle == nullptr)
+        {
+            close();
+            return false;
+        }
+
+        mapped_data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if (mapped_data == nullptr)
+        {
+            close();
+            return false;
+        }
+    }
+#else
+    file_descriptor = ::open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    {
+        close();
+        return false;
+    }
+    mapped_size = static_cast<size_t>(file_stat.st_size);
+
+    if (mapped_size > 0)
+    {
+        void* mapping = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close();
+            return false;
+        }
+        madvise(mapping, mapped_size, MADV_SEQUENTIAL);
+        mapped_data = static_cast<const char*>(mapping);
+    }
+#endif
+
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (mapped_data != nullptr)
+    {
+        UnmapViewOfFile(mapped_data);
+    }
+    if (mapping_handle != nullptr)
+    {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+    }
+    if (file_handle != nullptr)
+    {
+        CloseHandle(file_handle);
+        file_handle = nullptr;
+    }
+#else
+    if (mapped_data != nullptr)
+    {
+        munmap(const_cast<char*>(mapped_data), mapped_size);
+    }
+    if (file_descriptor >= 0)
+    {
+        ::close(file_descriptor);
+        file_descriptor = -1;
+    }
+#endif
+
+    mapped_data = nullptr;
+    mapped_size = 0;
+    opened = false;
+}
+
+bool MappedFile::is_open() const
+{
+    return opened;
+}
+
+const char* MappedFile::data() const
+{
+    return mapped_data;
+}
+
+size_t MappedFile::size() const
+{
+    return mapped_size;
+}
@@ -0,0 +1,164 @@
+#include "parameter_reporter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+using namespace std;
+
+ParameterReporter::~ParameterReporter()
+{
+    stop();
+}
+
+void ParameterReporter::start()
+{
+    stop();
+    should_stop = false;
+    thread = std::thread([this]()
+    {
+        thread_loop();
+    });
+}
+
+void ParameterReporter::publish(const parameters_t& parameters, const int32_t epoch, const tune_t error)
+{
+    {
+        unique_lock<mutex> lock(snapshot_mutex);
+        // Reuses the buffer's storage, after the first snapshot this is a plain copy
+        pending.parameters.assign(parameters.begin(), parameters.end());
+        pending.epoch = epoch;
+        pending.error = error;
+        has_pending = true;
+        // Text queued after a replaced snapshot now comes before the new one
+        text_before += text_after;
+        text_after.clear();
+    }
+    snapshot_condition.notify_one();
+}
+
+void ParameterReporter::print(const string& text)
+{
+    if (!thread.joinable())
+    {
+        cout << text << flush;
+        return;
+    }
+
+    {
+        unique_lock<mutex> lock(snapshot_mutex);
+        (has_pending ? text_after : text_before) += text;
+    }
+    snapshot_condition.notify_one();
+}
+
+void ParameterReporter::stop()
+{
+    if (!thread.joinable())
+    {
+        return;
+    }
+
+    {
+        unique_lock<mutex> lock(snapshot_mutex);
+        should_stop = true;
+    }
+    snapshot_condition.notify_one();
+    thread.join();
+}
+
+void ParameterReporter::thread_loop()
+{
+    string before;
+    string after;
+    while (true)
+    {
+        bool has_snapshot;
+        {
+            unique_lock<mutex> lock(snapshot_mutex);
+            snapshot_condition.wait(lock, [this]
+            {
+                return has_pending || !text_before.empty() || should_stop;
+            });
+
+            if (!has_pending && text_before.empty())
+            {
+                return;
+            }
+
+            has_snapshot = has_pending;
+            if (has_snapshot)
+            {
+                swap(pending, reporting);
+                has_pending = false;
+            }
+            // Swapping keeps both strings' storage, so queuing text rarely allocates
+            before.clear();
+            after.clear();
+            swap(before, text_before);
+            swap(after, text_after);
+        }
+
+        cout << before;
+        if (has_snapshot)
+        {
+            report(reporting);
+        }
+        cout << after << flush;
+    }
+}
+
+void ParameterReporter::report(const Snapshot& snapshot)
+{
+    TuneEval::print_parameters(snapshot.parameters);
+
+    if constexpr (string_view(parameter_report_path).empty())
+    {
+        return;
+    }
+
+    // Written to a temporary file and renamed, so a reader never sees a partial report
+    const string path = parameter_report_path;
+    const auto temp_path = path + ".tmp";
+    {
+        ofstream file(temp_path, ios::trunc);
+        if (!file)
+        {
+            cout << "Failed to create parameter report " << temp_path << endl;
+            return;
+        }
+
+        file.precision(numeric_limits<double>::max_digits10);
+        file << "{\"epoch\": " << snapshot.epoch << ", \"error\": " << static_cast<double>(snapshot.error) << ", \"parameters\": [";
+        for (size_t parameter_index = 0; parameter_index < snapshot.parameters.size(); parameter_index++)
+        {
+            if (parameter_index > 0)
+            {
+                file << ", ";
+            }
+            const auto& parameter = snapshot.parameters[parameter_index];
+#if TAPERED
+            file << "[" << static_cast<double>(parameter[static_cast<int32_t>(PhaseStages::Midgame)])
+                << ", " << static_cast<double>(parameter[static_cast<int32_t>(PhaseStages::Endgame)]) << "]";
+#else
+            file << static_cast<double>(parameter);
+#endif
+        }
+        file << "]}" << endl;
+        if (!file)
+        {
+            cout << "Failed to write parameter report " << temp_path << endl;
+            return;
+        }
+    }
+
+    error_code error;
+    filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        cout << "Failed to move parameter report to " << path << ": " << error.message() << endl;
+    }
+}
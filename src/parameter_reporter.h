@@ -0,0 +1,50 @@
+#ifndef PARAMETER_REPORTER_H
+#define PARAMETER_REPORTER_H 1
+
+#include "config.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Prints parameter snapshots and writes them to parameter_report_path on a background thread, so the epoch loop only pays for a copy.
+// A snapshot published while the previous one is still pending replaces it. While the thread runs it owns the console,
+// the epoch loop queues its lines with print instead of waiting for a report to finish.
+class ParameterReporter {
+public:
+    ~ParameterReporter();
+
+    void start();
+    void publish(const parameters_t& parameters, int32_t epoch, tune_t error);
+    // Queues text to be printed in order with the snapshots published around it, or prints it right away when the thread isn't running
+    void print(const std::string& text);
+    // Reports the last published snapshot and the queued text if still pending and ends the thread
+    void stop();
+
+private:
+    struct Snapshot
+    {
+        parameters_t parameters;
+        int32_t epoch = 0;
+        tune_t error = 0;
+    };
+
+    std::mutex snapshot_mutex;
+    std::condition_variable snapshot_condition;
+    // Double buffer, the epoch loop fills pending while the thread reports the other one
+    Snapshot pending;
+    Snapshot reporting;
+    bool has_pending = false;
+    // Text queued before and after the pending snapshot
+    std::string text_before;
+    std::string text_after;
+    bool should_stop = false;
+    std::thread thread;
+
+    void thread_loop();
+    void report(const Snapshot& snapshot);
+};
+
+#endif // !PARAMETER_REPORTER_H
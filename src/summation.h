@@ -0,0 +1,43 @@
+#ifndef SUMMATION_H
+#define SUMMATION_H 1
+
+#include <array>
+#include <cstdint>
+
+// Pairwise summation of a stream of values in O(log n) memory, rounding error grows with log(n) instead of n.
+// Unlike Kahan summation the compensation can't be optimized away by -ffast-math
+template<typename T>
+class PairwiseSum
+{
+public:
+    void add(T value)
+    {
+        int32_t level = 0;
+        for (auto pending = count; pending & 1; pending >>= 1)
+        {
+            value = partials[level] + value;
+            level++;
+        }
+        partials[level] = value;
+        count++;
+    }
+
+    T get() const
+    {
+        T total = 0;
+        for (int32_t level = 0; level < static_cast<int32_t>(partials.size()); level++)
+        {
+            if ((count >> level) & 1)
+            {
+                total += partials[level];
+            }
+        }
+        return total;
+    }
+
+private:
+    uint64_t count = 0;
+    std::array<T, 64> partials{};
+};
+
+#endif // !SUMMATION_H
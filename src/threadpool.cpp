@@ -1,19 +1,115 @@
 #include "threadpool.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <stdexcept>
 #include <thread>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace std;
 
-void ThreadPool::start(uint32_t thread_count)
+// Idle workers and a waiting parallel_for poll this many times before sleeping, so back to back epochs don't pay for a wakeup
+constexpr uint32_t idle_spin_count = 4096;
+
+static void cpu_relax()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#else
+    this_thread::yield();
+#endif
+}
+
+static bool pin_current_thread(const int32_t core)
+{
+#ifdef _WIN32
+    if (core >= 64)
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core) != 0;
+#elif defined(__linux__)
+    if (core >= CPU_SETSIZE)
+    {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
+
+// A range word holds, from the top bit down, whether the range may be stolen from, the low bits of the parallel_for's generation,
+// and the begin and end chunk indices. The tag makes a range read during one call never compare equal to a range of a later call.
+constexpr uint32_t range_index_bits = 24;
+constexpr uint32_t range_generation_bits = 63 - 2 * range_index_bits;
+constexpr uint64_t range_index_mask = (static_cast<uint64_t>(1) << range_index_bits) - 1;
+constexpr uint64_t range_tag_mask = ~((static_cast<uint64_t>(1) << (2 * range_index_bits)) - 1);
+constexpr uint64_t range_stealable_bit = static_cast<uint64_t>(1) << 63;
+constexpr size_t max_chunk_count = range_index_mask;
+
+static uint64_t make_range_tag(const uint64_t generation, const bool stealable)
+{
+    const auto generation_bits = generation & ((static_cast<uint64_t>(1) << range_generation_bits) - 1);
+    return (stealable ? range_stealable_bit : 0) | (generation_bits << (2 * range_index_bits));
+}
+
+static uint64_t pack_range(const uint64_t tag, const uint32_t begin, const uint32_t end)
+{
+    return tag | (static_cast<uint64_t>(begin) << range_index_bits) | end;
+}
+
+static uint64_t get_range_tag(const uint64_t range)
+{
+    return range & range_tag_mask;
+}
+
+static uint32_t get_range_begin(const uint64_t range)
+{
+    return static_cast<uint32_t>((range >> range_index_bits) & range_index_mask);
+}
+
+static uint32_t get_range_end(const uint64_t range)
+{
+    return static_cast<uint32_t>(range & range_index_mask);
+}
+
+static bool is_range_stealable(const uint64_t range)
+{
+    return (range & range_stealable_bit) != 0;
+}
+
+void ThreadPool::start(uint32_t thread_count, const vector<int32_t>& worker_cores)
 {
     stop();
     should_stop = false;
-    for (int thread_index = 0; thread_index < thread_count; thread_index++)
+    chunk_ranges = make_unique<ChunkRange[]>(thread_count);
+    worker_count = thread_count;
+
+    // With more threads than cores a spinning thread takes the core from one with work, so sleep right away instead
+    const auto core_count = thread::hardware_concurrency();
+    spin_count = core_count == 0 || thread_count < core_count ? idle_spin_count : 0;
+
+    for (uint32_t thread_index = 0; thread_index < thread_count; thread_index++)
     {
-        threads.emplace_back([this]()
+        const auto core = thread_index < worker_cores.size() ? worker_cores[thread_index] : -1;
+        threads.emplace_back([this, thread_index, core]()
         {
-            thread_loop();
+            thread_loop(thread_index, core);
         });
     }
 }
@@ -28,10 +124,100 @@ void ThreadPool::enqueue(const function<void()>& job)
     {
         unique_lock<mutex> lock(queue_mutex);
         jobs.push(job);
+        queued_job_count++;
     }
     mutex_condition.notify_one();
 }
 
+void ThreadPool::parallel_for(const size_t begin, const size_t end, const size_t grain, const RangeBody& body)
+{
+    run_chunks(begin, end, grain, body, true);
+}
+
+pair<size_t, size_t> ThreadPool::get_worker_share(const size_t begin, const size_t end, size_t grain, const uint32_t worker_index) const
+{
+    if (end <= begin || worker_count == 0)
+    {
+        return { begin, begin };
+    }
+
+    grain = std::max(grain, static_cast<size_t>(1));
+    const auto chunk_count = (end - begin + grain - 1) / grain;
+    const auto share_begin = chunk_count * worker_index / worker_count;
+    const auto share_end = chunk_count * (worker_index + 1) / worker_count;
+    return { std::min(begin + share_begin * grain, end), std::min(begin + share_end * grain, end) };
+}
+
+void ThreadPool::run_on_each_worker(const function<void(uint32_t worker_index)>& body)
+{
+    // One chunk per worker in its own share, with stealing off every worker runs exactly its own
+    run_chunks(0, worker_count, 1, [&body](size_t, size_t, const uint32_t worker_index)
+    {
+        body(worker_index);
+    }, false);
+}
+
+void ThreadPool::run_chunks(const size_t begin, const size_t end, size_t grain, const RangeBody& body, const bool allow_stealing)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    grain = std::max(grain, static_cast<size_t>(1));
+    const auto chunk_count = (end - begin + grain - 1) / grain;
+    if (threads.empty())
+    {
+        for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain)
+        {
+            body(chunk_begin, std::min(chunk_begin + grain, end), 0);
+        }
+        return;
+    }
+
+    if (chunk_count > max_chunk_count)
+    {
+        throw runtime_error("Too many chunks in parallel_for, increase the grain");
+    }
+
+    lock_guard<mutex> parallel_lock(parallel_mutex);
+    parallel_body = &body;
+    parallel_begin = begin;
+    parallel_end = end;
+    parallel_grain = grain;
+    remaining_chunk_count.store(chunk_count, memory_order_relaxed);
+
+    // Only one parallel_for runs at a time, so the generation it is about to publish is the next one
+    const auto range_tag = make_range_tag(parallel_generation.load(memory_order_relaxed) + 1, allow_stealing);
+    for (uint32_t worker_index = 0; worker_index < worker_count; worker_index++)
+    {
+        const auto share_begin = static_cast<uint32_t>(chunk_count * worker_index / worker_count);
+        const auto share_end = static_cast<uint32_t>(chunk_count * (worker_index + 1) / worker_count);
+        chunk_ranges[worker_index].range.store(pack_range(range_tag, share_begin, share_end), memory_order_release);
+    }
+
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        parallel_generation.fetch_add(1, memory_order_release);
+    }
+    mutex_condition.notify_all();
+
+    for (uint32_t spin = 0; spin < spin_count; spin++)
+    {
+        if (remaining_chunk_count.load(memory_order_acquire) == 0)
+        {
+            return;
+        }
+        cpu_relax();
+    }
+
+    unique_lock<mutex> lock(queue_mutex);
+    completion_condition.wait(lock, [this]
+    {
+        return remaining_chunk_count.load(memory_order_acquire) == 0;
+    });
+}
+
 void ThreadPool::stop()
 {
     {
@@ -66,34 +252,140 @@ void ThreadPool::wait_for_completion()
     }
 }
 
-void ThreadPool::thread_loop()
+void ThreadPool::thread_loop(const uint32_t worker_index, const int32_t core)
 {
+    if (core >= 0)
+    {
+        pin_current_thread(core);
+    }
+
     while (true)
     {
-        function<void()> job;
+        const auto seen_generation = parallel_generation.load(memory_order_acquire);
+
+        bool found_work = run_parallel_chunks(worker_index) || run_queued_job();
+        for (uint32_t spin = 0; spin < spin_count && !found_work; spin++)
         {
-            unique_lock<mutex> lock(queue_mutex);
-            mutex_condition.wait(lock, [this]
+            if (should_stop.load(memory_order_relaxed))
             {
-                return !jobs.empty() || should_stop;
-            });
+                return;
+            }
 
-            if (should_stop)
+            found_work = run_parallel_chunks(worker_index) || run_queued_job();
+            if (!found_work)
             {
-                return;
+                cpu_relax();
             }
+        }
 
-            job = jobs.front();
-            jobs.pop();
-            running_job_count++;
+        if (found_work)
+        {
+            continue;
         }
 
-        job();
+        unique_lock<mutex> lock(queue_mutex);
+        mutex_condition.wait(lock, [this, seen_generation]
+        {
+            return should_stop || !jobs.empty() || parallel_generation.load(memory_order_relaxed) != seen_generation;
+        });
 
+        if (should_stop)
         {
-            unique_lock<mutex> lock(queue_mutex);
-            running_job_count--;
-            completion_condition.notify_all();
+            return;
         }
     }
 }
+
+bool ThreadPool::run_queued_job()
+{
+    if (queued_job_count.load(memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    function<void()> job;
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        if (jobs.empty())
+        {
+            return false;
+        }
+
+        job = std::move(jobs.front());
+        jobs.pop();
+        queued_job_count--;
+        running_job_count++;
+    }
+
+    job();
+
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        running_job_count--;
+        completion_condition.notify_all();
+    }
+    return true;
+}
+
+bool ThreadPool::run_parallel_chunks(const uint32_t worker_index)
+{
+    auto& own_range = chunk_ranges[worker_index].range;
+    bool found_work = false;
+    while (true)
+    {
+        // Own chunks are taken from the front, so they are visited in order and thieves at the back rarely collide with the owner
+        auto range = own_range.load(memory_order_acquire);
+        const auto begin = get_range_begin(range);
+        const auto end = get_range_end(range);
+        if (begin < end)
+        {
+            if (own_range.compare_exchange_weak(range, pack_range(get_range_tag(range), begin + 1, end), memory_order_acq_rel, memory_order_acquire))
+            {
+                run_chunk(begin, worker_index);
+                found_work = true;
+            }
+            continue;
+        }
+
+        if (!steal_chunk(worker_index))
+        {
+            return found_work;
+        }
+        found_work = true;
+    }
+}
+
+bool ThreadPool::steal_chunk(const uint32_t worker_index)
+{
+    for (uint32_t offset = 1; offset < worker_count; offset++)
+    {
+        auto& victim_range = chunk_ranges[(worker_index + offset) % worker_count].range;
+        auto range = victim_range.load(memory_order_acquire);
+        // The stealable bit travels with the range, so a run_on_each_worker range is never stolen even by a thief that started during an earlier call
+        while (is_range_stealable(range) && get_range_begin(range) < get_range_end(range))
+        {
+            // Stolen chunks are run right away instead of moved to the own range, which a new parallel_for may be resetting
+            const auto end = get_range_end(range);
+            if (victim_range.compare_exchange_weak(range, pack_range(get_range_tag(range), get_range_begin(range), end - 1), memory_order_acq_rel, memory_order_acquire))
+            {
+                run_chunk(end - 1, worker_index);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_chunk(const uint32_t chunk_index, const uint32_t worker_index)
+{
+    // A claimed chunk keeps the parallel_for waiting, so its fields stay valid until the chunk is counted as done
+    const auto chunk_begin = parallel_begin + chunk_index * parallel_grain;
+    const auto chunk_end = std::min(chunk_begin + parallel_grain, parallel_end);
+    (*parallel_body)(chunk_begin, chunk_end, worker_index);
+
+    if (remaining_chunk_count.fetch_sub(1, memory_order_acq_rel) == 1)
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        completion_condition.notify_all();
+    }
+}
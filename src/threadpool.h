@@ -1,31 +1,70 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H 1
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <utility>
+#include <vector>
 
 class ThreadPool {
 public:
-    void start(uint32_t thread_count);
+    // Called with a range of at most grain items and the index of the worker running it
+    using RangeBody = std::function<void(size_t begin, size_t end, uint32_t worker_index)>;
+
+    // Worker i is pinned to logical core worker_cores[i] if given
+    void start(uint32_t thread_count, const std::vector<int32_t>& worker_cores = {});
     uint32_t thread_count() const;
     void enqueue(const std::function<void()>& job);
+    // Runs body over [begin, end) in chunks of grain items and returns when all chunks are done.
+    // Each worker starts on its own share of the chunks, workers that run out take chunks from the end of other shares.
+    void parallel_for(size_t begin, size_t end, size_t grain, const RangeBody& body);
+    // Items of [begin, end) in the share parallel_for starts the worker with, for placing data where that worker will read it
+    std::pair<size_t, size_t> get_worker_share(size_t begin, size_t end, size_t grain, uint32_t worker_index) const;
+    // Runs body exactly once on every worker
+    void run_on_each_worker(const std::function<void(uint32_t worker_index)>& body);
     void stop();
     bool is_idle();
     void wait_for_completion();
 
 private:
-    bool should_stop = false;
+    // Remaining chunk indices of one worker together with a tag of the parallel_for they belong to, packed so all change in one CAS
+    struct alignas(64) ChunkRange
+    {
+        std::atomic<uint64_t> range{ 0 };
+    };
+
+    std::atomic<bool> should_stop = false;
+    uint32_t spin_count = 0;
+    // Set before the workers start, unlike the size of threads
+    uint32_t worker_count = 0;
     uint32_t running_job_count = 0;
+    std::atomic<uint32_t> queued_job_count = 0;
     std::mutex queue_mutex;
     std::condition_variable mutex_condition;
     std::condition_variable completion_condition;
     std::vector<std::thread> threads;
     std::queue<std::function<void()>> jobs;
 
-    void thread_loop();
+    std::mutex parallel_mutex;
+    std::unique_ptr<ChunkRange[]> chunk_ranges;
+    std::atomic<uint64_t> parallel_generation = 0;
+    std::atomic<size_t> remaining_chunk_count = 0;
+    const RangeBody* parallel_body = nullptr;
+    size_t parallel_begin = 0;
+    size_t parallel_end = 0;
+    size_t parallel_grain = 0;
+
+    void run_chunks(size_t begin, size_t end, size_t grain, const RangeBody& body, bool allow_stealing);
+    void thread_loop(uint32_t worker_index, int32_t core);
+    bool run_queued_job();
+    bool run_parallel_chunks(uint32_t worker_index);
+    bool steal_chunk(uint32_t worker_index);
+    void run_chunk(uint32_t chunk_index, uint32_t worker_index);
 };
 
 #endif // !THREADPOOL_H
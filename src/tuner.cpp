@@ -1,17 +1,35 @@
 #include "tuner.h"
+#include "checkpoint.h"
 #include "config.h"
+#include "dataset.h"
+#include "dataset_cache.h"
+#include "fen_line.h"
+#include "gradient_kernels.h"
+#include "summation.h"
 #include "threadpool.h"
+#include "bounded_queue.h"
+#include "mapped_file.h"
+#include "parameter_reporter.h"
 #include "external/chess.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <csignal>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <random>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -22,108 +40,28 @@ using namespace Tuner;
 static_assert(false, "Tuner requires TAPERED to be defined")
 #endif
 
-struct WdlMarker
+// Parameter count the eval declares at compile time, 0 if only get_initial_parameters knows it
+template<typename Eval>
+static constexpr size_t get_static_parameter_count()
 {
-    string marker;
-    tune_t wdl;
-};
-
-struct CoefficientEntry
-{
-    int16_t value;
-    int16_t index;
-};
-
-struct Entry
-{
-    uint32_t coeff_offset;
-    uint16_t coeff_count;
-    tune_t wdl;
-    bool white_to_move;
-    tune_t additional_score;
-#if TAPERED
-    int32_t phase;
-    tune_t endgame_scale;
-#endif
-};
-
-static const array<WdlMarker, 4> markers
-{
-    WdlMarker{"1.0", 1},
-
-    WdlMarker{"1-0", 1},
-    WdlMarker{"1/2-1/2", 0.5},
-    WdlMarker{"0-1", 0}
-};
-
-static tune_t get_fen_wdl(const string& original_fen, const bool original_white_to_move, const bool side_to_move_wdl)
-{
-    tune_t wdl;
-    bool marker_found = false;
-    for (auto& marker : markers)
-    {
-        if (original_fen.find(marker.marker) != std::string::npos)
-        {
-            if (marker_found)
-            {
-                cout << "WDL marker already found on line " << original_fen << endl;
-                throw std::runtime_error("WDL marker already found");
-            }
-            marker_found = true;
-            wdl = marker.wdl;
-        }
-    }
-
-    if(!marker_found)
-    {
-        stringstream ss(original_fen);
-        while (!ss.eof())
-        {
-            string word;
-            ss >> word;
-            if (word.starts_with("0."))
-            {
-                wdl = stod(word);
-                marker_found = true;
-            }
-            else if (word.starts_with("[0."))
-            {
-                wdl = stod(word.substr(1, word.size() - 2));
-                marker_found = true;
-            }
-        }
-    }
-
-    if (!marker_found)
-    {
-        cout << "WDL marker not found on line " << original_fen << endl;
-        throw std::runtime_error("WDL marker not found");
-    }
-
-    if(!original_white_to_move && side_to_move_wdl)
+    if constexpr (requires { Eval::parameter_count; })
     {
-        wdl = 1 - wdl;
+        return Eval::parameter_count;
     }
-
-    return wdl;
-}   
-
-static bool get_fen_color_to_move(const string& fen)
-{
-    auto space_pos = fen.find(' ');
-    if (space_pos != string::npos && space_pos + 1 < fen.size())
+    else
     {
-        return fen[space_pos + 1] == 'w';
+        return 0;
     }
-    return true;
 }
 
-static void print_elapsed(high_resolution_clock::time_point start)
+constexpr size_t static_parameter_count = get_static_parameter_count<TuneEval>();
+
+static void print_elapsed(high_resolution_clock::time_point start, ostream& out = cout)
 {
     const auto now = high_resolution_clock::now();
     const auto elapsed = now - start;
     const auto elapsed_seconds = duration_cast<seconds>(elapsed).count();
-    cout << "[" << elapsed_seconds << "s] ";
+    out << "[" << elapsed_seconds << "s] ";
 }
 
 static void get_coefficient_entries(const coefficients_t& coefficients, vector<CoefficientEntry>& all_coefficients, Entry& entry, int32_t parameter_count)
@@ -135,6 +73,7 @@ static void get_coefficient_entries(const coefficients_t& coefficients, vector<C
 
     entry.coeff_offset = static_cast<uint32_t>(all_coefficients.size());
 
+    vector<int16_t> escaped_values;
     for (int32_t i = 0; i < static_cast<int32_t>(coefficients.size()); i++)
     {
         if (coefficients[i] == 0)
@@ -142,35 +81,35 @@ static void get_coefficient_entries(const coefficients_t& coefficients, vector<C
             continue;
         }
 
-        all_coefficients.push_back(CoefficientEntry{coefficients[i], static_cast<int16_t>(i)});
+        const auto code = coefficient_values.get_code(coefficients[i]);
+        if (code == coefficient_escape_code)
+        {
+            escaped_values.push_back(coefficients[i]);
+        }
+        all_coefficients.push_back(CoefficientEntry{code, static_cast<uint32_t>(i)});
     }
 
     entry.coeff_count = static_cast<uint16_t>(all_coefficients.size() - entry.coeff_offset);
+    if constexpr (compress_coefficients)
+    {
+        compress_coefficient_run(all_coefficients, entry.coeff_offset, entry.coeff_count);
+    }
+    append_escaped_values(all_coefficients, escaped_values);
 }
 
 static tune_t linear_eval(const Entry& entry, const CoefficientEntry* all_coefficients, const parameters_t& parameters)
 {
-    tune_t score = entry.additional_score;
-    const auto* coefficients = all_coefficients + entry.coeff_offset;
-    const auto count = entry.coeff_count;
-#if TAPERED 
-    tune_t midgame = 0;
-    tune_t endgame = 0;
-    for (uint16_t ci = 0; ci < count; ci++)
+    array<tune_t, phase_count> phase_scores{};
+    for_each_coefficient(entry, all_coefficients, [&phase_scores, &parameters](const CoefficientEntry coefficient, const int16_t raw_value)
     {
-        const auto& coefficient = coefficients[ci];
-        midgame += coefficient.value * parameters[coefficient.index][static_cast<int32_t>(PhaseStages::Midgame)];
-        endgame += coefficient.value * parameters[coefficient.index][static_cast<int32_t>(PhaseStages::Endgame)];
-    }
-    score += (midgame * entry.phase + endgame * entry.endgame_scale * (24 - entry.phase)) / 24;
-#else
-    for (uint16_t ci = 0; ci < count; ci++)
-    {
-        score += coefficients[ci].value * parameters[coefficients[ci].index];
-    }
-#endif
-
-    return score;
+        const auto& parameter = parameters[coefficient.get_index()];
+        const auto value = static_cast<tune_t>(raw_value);
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            phase_scores[phase] += value * get_phase_value(parameter, phase);
+        }
+    });
+    return entry.additional_score + entry.blend_phases(phase_scores);
 }
 
 static int32_t get_phase(const string& fen)
@@ -251,7 +190,7 @@ static int32_t get_phase(const chess::Board& board)
     return phase;
 }
 
-static void print_statistics(const parameters_t& parameters, const vector<Entry>& entries)
+static void print_statistics(const parameters_t& parameters, const vector<Entry>& entries, const vector<EntryInfo>& entry_infos)
 {
     array<size_t, 2> wins{};
     array<size_t, 2> draws{};
@@ -263,22 +202,25 @@ static void print_statistics(const parameters_t& parameters, const vector<Entry>
     size_t max_parameters = 0;
     size_t total_parameters = 0;
 
-    for(const auto& entry : entries)
+    for(size_t entry_index = 0; entry_index < entries.size(); entry_index++)
     {
-        if(entry.wdl == 1)
+        const auto& entry = entries[entry_index];
+        const auto white_to_move = entry_infos[entry_index].white_to_move;
+        const auto wdl = entry.get_wdl();
+        if(wdl == 1)
         {
-            wins[entry.white_to_move]++;
+            wins[white_to_move]++;
         }
-        else if(entry.wdl == 0.5)
+        else if(wdl == 0.5)
         {
-            draws[entry.white_to_move]++;
+            draws[white_to_move]++;
         }
-        else if (entry.wdl == 0.0)
+        else if (wdl == 0.0)
         {
-            losses[entry.white_to_move]++;
+            losses[white_to_move]++;
         }
-        total[entry.white_to_move]++;
-        wdls[entry.white_to_move] += entry.wdl;
+        total[white_to_move]++;
+        wdls[white_to_move] += wdl;
 
         const size_t coeff_count = entry.coeff_count;
         if(coeff_count < min_parameters)
@@ -388,20 +330,21 @@ static tune_t quiescence(chess::Board& board, const parameters_t& parameters, pv
     }
 
     const auto scratch_save = scratch.size();
+    const bool white_to_move = board.sideToMove() == chess::Color::WHITE;
     Entry entry;
-    entry.white_to_move = board.sideToMove() == chess::Color::WHITE;
+    entry.weight = 1;
 #if TAPERED
-    entry.endgame_scale = eval_result.endgame_scale;
+    entry.set_endgame_scale(eval_result.endgame_scale);
 #endif
     get_coefficient_entries(eval_result.coefficients, scratch, entry, static_cast<int32_t>(parameters.size()));
 #if TAPERED
-    entry.phase = get_phase(board);
+    entry.phase = static_cast<uint8_t>(get_phase(board));
 #endif
     entry.additional_score = 0;
     tune_t eval = linear_eval(entry, scratch.data(), parameters);
     scratch.resize(scratch_save);
 
-    if(!entry.white_to_move)
+    if(!white_to_move)
     {
         eval = -eval;
     }
@@ -482,23 +425,6 @@ static tune_t quiescence(chess::Board& board, const parameters_t& parameters, pv
     return best_score;
 }
 
-string cleanup_fen(const string& initial_fen)
-{
-    int space_count = 0;
-    size_t pos = 0;
-    for (size_t i = 0; i < initial_fen.size(); ++i) {
-        if (initial_fen[i] == ' ') {
-            ++space_count;
-        }
-        if (space_count == 4) {
-            pos = i;
-            break;
-        }
-    }
-    const auto clean_fen = initial_fen.substr(0, pos);
-    return clean_fen;
-}
-
 chess::Board quiescence_root(const parameters_t& parameters, chess::Board board, vector<CoefficientEntry>& scratch)
 {
     pv_table_t pv_table {};
@@ -528,21 +454,13 @@ chess::Board quiescence_root(const parameters_t& parameters, chess::Board board,
     return board;
 }
 
-static void parse_fen(const bool side_to_move_wdl, const parameters_t& parameters, vector<Entry>& entries, vector<CoefficientEntry>& all_coefficients, const string& original_fen)
+static FenLineStatus parse_fen_position(const bool side_to_move_wdl, const parameters_t& parameters, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients, const FenLine& fen_line, chess::Board& board, const uint64_t position_hash)
 {
-    if constexpr (print_data_entries)
-    {
-        cout << original_fen;
-    }
-
-    //string fen;
-    const auto clean_fen = cleanup_fen(original_fen);
-    chess::Board board = chess::Board(clean_fen);
-
-    if constexpr (TuneEval::filter_in_check)
+    // Entry clamps instead of throwing in the parse workers, so values it can't store are rejected here
+    const auto wdl = !fen_line.white_to_move && side_to_move_wdl ? 1 - fen_line.wdl : fen_line.wdl;
+    if (!Entry::is_valid_wdl(wdl))
     {
-        if (board.inCheck())
-            return;
+        return FenLineStatus::WdlOutOfRange;
     }
 
     if constexpr (TuneEval::enable_qsearch)
@@ -562,18 +480,25 @@ static void parse_fen(const bool side_to_move_wdl, const parameters_t& parameter
         eval_result = TuneEval::get_fen_eval_result(fen);
     }
 
+#if TAPERED
+    if (!Entry::is_valid_endgame_scale(eval_result.endgame_scale))
+    {
+        return FenLineStatus::EndgameScaleOutOfRange;
+    }
+#endif
+
     Entry entry;
-    //entry.white_to_move = get_fen_color_to_move(fen);
-    entry.white_to_move = board.sideToMove() == chess::Color::WHITE;
+    entry.weight = 1;
+    EntryInfo entry_info;
+    entry_info.white_to_move = board.sideToMove() == chess::Color::WHITE;
+    entry_info.validation = validation_fraction > 0 && is_validation_position(position_hash);
 #if TAPERED
-    entry.endgame_scale = eval_result.endgame_scale;
+    entry.set_endgame_scale(eval_result.endgame_scale);
 #endif
-    const bool original_white_to_move = get_fen_color_to_move(original_fen);
-    //cout << (entry.white_to_move ? "w" : "b") << " ";
-    entry.wdl = get_fen_wdl(original_fen, original_white_to_move, side_to_move_wdl);
+    entry.set_wdl(wdl);
     get_coefficient_entries(eval_result.coefficients, all_coefficients, entry, static_cast<int32_t>(parameters.size()));
 #if TAPERED
-    entry.phase = get_phase(board);
+    entry.phase = static_cast<uint8_t>(get_phase(board));
 #endif
     entry.additional_score = 0;
     if constexpr (TuneEval::includes_additional_score)
@@ -583,21 +508,105 @@ static void parse_fen(const bool side_to_move_wdl, const parameters_t& parameter
         {
             cout << " Eval: " << score << endl;
         }
-        entry.additional_score = eval_result.score - score;
+        entry.additional_score = static_cast<float>(eval_result.score - score);
     }
 
     entries.push_back(entry);
+    entry_infos.push_back(entry_info);
+    return FenLineStatus::Ok;
 }
 
-static void read_fens(const DataSource& source, const high_resolution_clock::time_point start, vector<string>& fens)
+static FenLineStatus parse_fen(const bool side_to_move_wdl, const parameters_t& parameters, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients, const string_view original_fen)
 {
-    cout << "Reading " << source.path;
-    if (source.position_limit > 0)
+    FenLine fen_line;
+    const auto status = parse_fen_line(original_fen, fen_line);
+    if (status != FenLineStatus::Ok)
     {
-        cout << " (" << source.position_limit << " positions)";
+        return status;
     }
-    cout << "..." << endl;
 
+    if constexpr (print_data_entries)
+    {
+        cout << original_fen;
+    }
+
+    chess::Board board = chess::Board(fen_line.position);
+    const auto position_hash = board.hash();
+
+    if constexpr (TuneEval::filter_in_check)
+    {
+        if (board.inCheck())
+            return FenLineStatus::Ok;
+    }
+
+    return parse_fen_position(side_to_move_wdl, parameters, entries, entry_infos, all_coefficients, fen_line, board, position_hash);
+}
+
+// Lines are handed from the streaming reader to the parse workers in chunks of this many positions
+constexpr int64_t fen_chunk_size = 16384;
+// Memory mapped files are parsed in chunks of about this many bytes, roughly fen_chunk_size lines of a typical EPD
+constexpr size_t mapped_chunk_size = size_t(1) << 20;
+constexpr size_t fen_chunk_queue_capacity = 2 * data_load_thread_count;
+constexpr int64_t parse_progress_batch = 1024;
+constexpr size_t max_reported_malformed_lines = 10;
+
+struct FenChunk
+{
+    int64_t chunk_index;
+    vector<string> fens;
+};
+
+struct MalformedLine
+{
+    int64_t line_index;
+    FenLineStatus status;
+    string line;
+};
+
+struct ParsedChunk
+{
+    int64_t chunk_index;
+    int64_t fen_count = 0;
+    // An empty line was reached inside the chunk, nothing after it belongs to the data source
+    bool ends_data = false;
+    vector<Entry> entries;
+    vector<EntryInfo> entry_infos;
+    vector<CoefficientEntry> coefficients;
+    int64_t malformed_count = 0;
+    vector<MalformedLine> malformed_lines;
+};
+
+static void parse_chunk_fen(const bool side_to_move_wdl, const parameters_t& parameters, ParsedChunk& chunk, const string_view original_fen)
+{
+    const auto line_index = chunk.fen_count;
+    chunk.fen_count++;
+
+    const auto status = parse_fen(side_to_move_wdl, parameters, chunk.entries, chunk.entry_infos, chunk.coefficients, original_fen);
+    if (status == FenLineStatus::Ok)
+    {
+        return;
+    }
+
+    chunk.malformed_count++;
+    if (chunk.malformed_lines.size() < max_reported_malformed_lines)
+    {
+        chunk.malformed_lines.push_back(MalformedLine{ line_index, status, string(original_fen) });
+    }
+}
+
+static void add_parsed_count(atomic<int64_t>& parsed_count, const int64_t count, const high_resolution_clock::time_point time_start)
+{
+    const auto previous = parsed_count.fetch_add(count);
+    constexpr auto print_interval = TuneEval::data_load_print_interval;
+    if ((previous + count) / print_interval != previous / print_interval)
+    {
+        print_elapsed(time_start);
+        std::cout << "Parsed ~" << (previous + count) / print_interval * print_interval << " positions..." << endl;
+    }
+}
+
+static int64_t read_fens(const DataSource& source, BoundedQueue<FenChunk>& chunk_queue)
+{
     ifstream file(source.path);
     if (!file)
     {
@@ -605,14 +614,13 @@ static void read_fens(const DataSource& source, const high_resolution_clock::tim
         throw runtime_error("Failed to open data source");
     }
 
-    if (source.position_limit > 0)
-    {
-        fens.reserve(source.position_limit);
-    }
-
+    int64_t fen_count = 0;
+    int64_t chunk_index = 0;
+    FenChunk chunk{ chunk_index, {} };
+    chunk.fens.reserve(fen_chunk_size);
     while (!file.eof())
     {
-        if (source.position_limit > 0 && static_cast<int64_t>(fens.size()) >= source.position_limit)
+        if (source.position_limit > 0 && fen_count >= source.position_limit)
         {
             break;
         }
@@ -628,245 +636,1566 @@ static void read_fens(const DataSource& source, const high_resolution_clock::tim
             break;
         }
 
-        fens.push_back(original_fen);
+        chunk.fens.push_back(std::move(original_fen));
+        fen_count++;
+
+        if (static_cast<int64_t>(chunk.fens.size()) == fen_chunk_size)
+        {
+            chunk_queue.push(std::move(chunk));
+            chunk_index++;
+            chunk = FenChunk{ chunk_index, {} };
+            chunk.fens.reserve(fen_chunk_size);
+        }
+    }
+
+    if (!chunk.fens.empty())
+    {
+        chunk_queue.push(std::move(chunk));
     }
 
-    print_elapsed(start);
-    std::cout << "Read " << fens.size() << " positions from " << source.path << endl;
+    return fen_count;
 }
 
-static void parse_fens(ThreadPool& thread_pool, const DataSource& source, const vector<string>& fens, const parameters_t& parameters, const high_resolution_clock::time_point time_start, vector<Entry>& entries, vector<CoefficientEntry>& all_coefficients)
+static void parse_fens(ThreadPool& thread_pool, const DataSource& source, BoundedQueue<FenChunk>& chunk_queue, const parameters_t& parameters, const high_resolution_clock::time_point time_start, atomic<int64_t>& parsed_count, array<vector<ParsedChunk>, data_load_thread_count>& thread_chunks)
 {
-    cout << "Parsing " << fens.size() << " positions..." << endl;
-    array<vector<Entry>, data_load_thread_count> thread_entries;
-    array<vector<CoefficientEntry>, data_load_thread_count> thread_coefficients;
     const auto side_to_move_wdl = source.side_to_move_wdl;
 
     for (int thread_id = 0; thread_id < data_load_thread_count; thread_id++)
     {
-        thread_pool.enqueue([thread_id, &thread_entries, &thread_coefficients, &fens, &parameters, side_to_move_wdl, time_start]()
+        thread_pool.enqueue([thread_id, &thread_chunks, &chunk_queue, &parameters, side_to_move_wdl, time_start, &parsed_count]()
         {
-            const auto start = static_cast<size_t>(thread_id) * fens.size() / data_load_thread_count;
-            const auto end = static_cast<size_t>(thread_id + 1) * fens.size() / data_load_thread_count;
-
-            auto& local_entries = thread_entries[thread_id];
-            auto& local_coefficients = thread_coefficients[thread_id];
-            local_entries.reserve(end - start);
-
-            constexpr auto print_interval = TuneEval::data_load_print_interval / data_load_thread_count;
-            for (size_t i = start; i < end; i++)
+            auto& local_chunks = thread_chunks[thread_id];
+            while (auto chunk = chunk_queue.pop())
             {
-                parse_fen(side_to_move_wdl, parameters, local_entries, local_coefficients, fens[i]);
-                const auto count = static_cast<int>(i - start + 1);
-                if (thread_id == 0 && count % print_interval == 0)
+                ParsedChunk parsed{};
+                parsed.chunk_index = chunk->chunk_index;
+                parsed.entries.reserve(chunk->fens.size());
+                parsed.entry_infos.reserve(chunk->fens.size());
+                for (const auto& fen : chunk->fens)
                 {
-                    print_elapsed(time_start);
-                    std::cout << "Parsed ~" << count * data_load_thread_count << " positions..." << endl;
+                    parse_chunk_fen(side_to_move_wdl, parameters, parsed, fen);
                 }
+                local_chunks.push_back(std::move(parsed));
+                add_parsed_count(parsed_count, static_cast<int64_t>(chunk->fens.size()), time_start);
             }
         });
     }
+}
 
-    thread_pool.wait_for_completion();
-
-    // Calculate total sizes for reservation
-    size_t total_new_entries = 0;
-    size_t total_new_coefficients = 0;
-    for (int thread_id = 0; thread_id < data_load_thread_count; thread_id++)
+static const char* find_position_limit_end(const char* begin, const char* end, const int64_t position_limit)
+{
+    const char* current = begin;
+    for (int64_t line = 0; line < position_limit && current < end; line++)
     {
-        total_new_entries += thread_entries[thread_id].size();
-        total_new_coefficients += thread_coefficients[thread_id].size();
+        const auto* newline = static_cast<const char*>(memchr(current, '\n', end - current));
+        if (newline == nullptr)
+        {
+            return end;
+        }
+        current = newline + 1;
     }
-    entries.reserve(entries.size() + total_new_entries);
-    all_coefficients.reserve(all_coefficients.size() + total_new_coefficients);
+    return current;
+}
 
-    // Merge thread results with coefficient offset adjustment
-    for (int thread_id = 0; thread_id < data_load_thread_count; thread_id++)
+static void parse_mapped_fens(ThreadPool& thread_pool, const DataSource& source, const MappedFile& file, const parameters_t& parameters, const high_resolution_clock::time_point time_start, atomic<int64_t>& parsed_count, vector<ParsedChunk>& parsed_chunks)
+{
+    const char* data_begin = file.data();
+    const char* data_end = data_begin + file.size();
+    if (source.position_limit > 0)
     {
-        const auto coeff_offset_base = static_cast<uint32_t>(all_coefficients.size());
-        all_coefficients.insert(all_coefficients.end(),
-            thread_coefficients[thread_id].begin(),
-            thread_coefficients[thread_id].end());
+        data_end = find_position_limit_end(data_begin, data_end, source.position_limit);
+    }
 
-        for (auto& entry : thread_entries[thread_id])
+    // Split the mapping into chunks of about mapped_chunk_size bytes, each starting right after a newline.
+    // Workers that finish early take chunks from the others, and chunks are merged by index, not by worker.
+    vector<const char*> boundaries{ data_begin };
+    while (boundaries.back() < data_end)
+    {
+        const char* split = boundaries.back() + std::min(static_cast<ptrdiff_t>(mapped_chunk_size), data_end - boundaries.back());
+        if (split < data_end)
         {
-            entry.coeff_offset += coeff_offset_base;
-            entries.push_back(entry);
+            const auto* newline = static_cast<const char*>(memchr(split - 1, '\n', data_end - (split - 1)));
+            split = newline == nullptr ? data_end : newline + 1;
         }
+        boundaries.push_back(split);
     }
-}
 
-static void load_fens(ThreadPool& thread_pool, const DataSource& source, const parameters_t& parameters, const high_resolution_clock::time_point start, vector<Entry>& entries, vector<CoefficientEntry>& all_coefficients)
-{
-    vector<string> fens;
-    read_fens(source, start, fens);
-    parse_fens(thread_pool, source, fens, parameters, start, entries, all_coefficients);
-}
+    const auto chunk_count = boundaries.size() - 1;
+    parsed_chunks.resize(chunk_count);
+    const auto side_to_move_wdl = source.side_to_move_wdl;
+    thread_pool.parallel_for(0, chunk_count, 1, [&parsed_chunks, &boundaries, &parameters, side_to_move_wdl, time_start, &parsed_count](const size_t chunk_index, size_t, uint32_t)
+    {
+        auto& parsed = parsed_chunks[chunk_index];
+        parsed.chunk_index = static_cast<int64_t>(chunk_index);
+        const char* current = boundaries[chunk_index];
+        const char* range_end = boundaries[chunk_index + 1];
+        int64_t unreported_count = 0;
+        while (current < range_end)
+        {
+            const auto* newline = static_cast<const char*>(memchr(current, '\n', range_end - current));
+            const char* line_end = newline == nullptr ? range_end : newline;
+            string_view original_fen(current, line_end - current);
+            current = newline == nullptr ? range_end : newline + 1;
 
-static tune_t sigmoid(const tune_t K, const tune_t eval)
-{
-    return static_cast<tune_t>(1) / (static_cast<tune_t>(1) + exp(-K * eval / static_cast<tune_t>(400)));
+            if (!original_fen.empty() && original_fen.back() == '\r')
+            {
+                original_fen.remove_suffix(1);
+            }
+            if (original_fen.empty())
+            {
+                parsed.ends_data = true;
+                break;
+            }
+
+            parse_chunk_fen(side_to_move_wdl, parameters, parsed, original_fen);
+
+            unreported_count++;
+            if (unreported_count == parse_progress_batch)
+            {
+                add_parsed_count(parsed_count, unreported_count, time_start);
+                unreported_count = 0;
+            }
+        }
+        add_parsed_count(parsed_count, unreported_count, time_start);
+    });
 }
 
-static tune_t get_average_error(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters, tune_t K)
+static int64_t merge_parsed_chunks(const DataSource& source, vector<ParsedChunk>& parsed_chunks, CoefficientDeduplicator& deduplicator, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients)
 {
-    array<tune_t, thread_count> thread_errors{};
-    for(int thread_id = 0; thread_id < thread_count; thread_id++)
+    vector<ParsedChunk*> chunks;
+    for (auto& chunk : parsed_chunks)
+    {
+        chunks.push_back(&chunk);
+    }
+
+    // Merge in file order, so the dataset layout doesn't depend on thread scheduling
+    sort(chunks.begin(), chunks.end(), [](const ParsedChunk* left, const ParsedChunk* right)
+    {
+        return left->chunk_index < right->chunk_index;
+    });
+
+    const auto end_chunk = find_if(chunks.begin(), chunks.end(), [](const ParsedChunk* chunk)
+    {
+        return chunk->ends_data;
+    });
+    if (end_chunk != chunks.end())
+    {
+        chunks.erase(end_chunk + 1, chunks.end());
+    }
+
+    size_t total_new_entries = 0;
+    size_t total_new_coefficients = 0;
+    for (const auto* chunk : chunks)
     {
-        thread_pool.enqueue([thread_id, &thread_errors, &entries, all_coefficients, &parameters, K]()
+        total_new_entries += chunk->entries.size();
+        total_new_coefficients += chunk->coefficients.size();
+    }
+    entries.reserve(entries.size() + total_new_entries);
+    entry_infos.reserve(entry_infos.size() + total_new_entries);
+    all_coefficients.reserve(all_coefficients.size() + total_new_coefficients);
+
+    int64_t fen_count = 0;
+    int64_t malformed_count = 0;
+    for (auto* chunk : chunks)
+    {
+        // Chunks hold consecutive lines, so line numbers follow from the lines in all previous chunks
+        for (const auto& malformed_line : chunk->malformed_lines)
         {
-            const auto start = static_cast<int64_t>(thread_id) * entries.size() / thread_count;
-            const auto end = static_cast<int64_t>(thread_id + 1) * entries.size() / thread_count;
-            tune_t error = 0;
-            for (int64_t i = start; i < end; i++)
+            if (malformed_count < static_cast<int64_t>(max_reported_malformed_lines))
             {
-                const auto& entry = entries[i];
-                const auto eval = linear_eval(entry, all_coefficients, parameters);
-                const auto sig = sigmoid(K, eval);
-                const auto diff = entry.wdl - sig;
-                const auto entry_error = diff * diff;
-                error += entry_error;
+                cout << "Skipping " << source.path << " line " << fen_count + malformed_line.line_index + 1 << ", " << get_fen_line_status_description(malformed_line.status) << ": " << malformed_line.line << endl;
             }
-            thread_errors[thread_id] = error;
-        });
-    }
+            malformed_count++;
+        }
+        malformed_count += chunk->malformed_count - static_cast<int64_t>(chunk->malformed_lines.size());
 
-    thread_pool.wait_for_completion();
+        for (auto& entry : chunk->entries)
+        {
+            const auto* coefficients = chunk->coefficients.data() + entry.coeff_offset;
+            entry.coeff_offset = deduplicator.add(coefficients, get_coefficient_run_size(coefficients, entry.coeff_count), all_coefficients);
+            entries.push_back(entry);
+        }
+        entry_infos.insert(entry_infos.end(), chunk->entry_infos.begin(), chunk->entry_infos.end());
+
+        fen_count += chunk->fen_count;
+        vector<Entry>().swap(chunk->entries);
+        vector<EntryInfo>().swap(chunk->entry_infos);
+        vector<CoefficientEntry>().swap(chunk->coefficients);
+    }
 
-    tune_t total_error = 0;
-    for (int thread_id = 0; thread_id < thread_count; thread_id++)
+    if (malformed_count > 0)
     {
-        total_error += thread_errors[thread_id];
+        cout << "Skipped " << malformed_count << " malformed lines in " << source.path << endl;
     }
 
-    const tune_t avg_error = total_error / static_cast<tune_t>(entries.size());
-    return avg_error;
+    return fen_count - malformed_count;
 }
 
-static tune_t find_optimal_k(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters)
+static void load_fens(ThreadPool& thread_pool, const DataSource& source, const parameters_t& parameters, const high_resolution_clock::time_point start, CoefficientDeduplicator& deduplicator, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients)
 {
-    constexpr tune_t rate = 10;
-    constexpr tune_t delta = 1e-5;
-    constexpr tune_t deviation_goal = 1e-6;
-    tune_t K = 2.5;
-    tune_t deviation = 1;
+    cout << "Reading and parsing " << source.path;
+    if (source.position_limit > 0)
+    {
+        cout << " (" << source.position_limit << " positions)";
+    }
+    cout << "..." << endl;
 
-    while (fabs(deviation) > deviation_goal)
+    atomic<int64_t> parsed_count = 0;
+    vector<ParsedChunk> parsed_chunks;
+
+    // Regular files are parsed straight out of a memory mapping, anything that can't be mapped is streamed
+    MappedFile file;
+    if (file.open(source.path))
     {
-        const tune_t up = get_average_error(thread_pool, entries, all_coefficients, parameters, K + delta);
-        const tune_t down = get_average_error(thread_pool, entries, all_coefficients, parameters, K - delta);
-        deviation = (up - down) / (2 * delta);
-        cout << "Current K: " << K << ", up: " << up << ", down: " << down << ", deviation: " << deviation << endl;
-        K -= deviation * rate;
+        parse_mapped_fens(thread_pool, source, file, parameters, start, parsed_count, parsed_chunks);
     }
+    else
+    {
+        // Parse workers consume chunks while this thread is still reading, the bounded queue keeps the raw lines in flight small.
+        // The workers are queued jobs rather than a parallel_for, which would keep this thread from reading until they are done.
+        array<vector<ParsedChunk>, data_load_thread_count> thread_chunks;
+        BoundedQueue<FenChunk> chunk_queue(fen_chunk_queue_capacity);
+        parse_fens(thread_pool, source, chunk_queue, parameters, start, parsed_count, thread_chunks);
 
-    return K;
-}
+        try
+        {
+            read_fens(source, chunk_queue);
+        }
+        catch (...)
+        {
+            chunk_queue.close();
+            thread_pool.wait_for_completion();
+            throw;
+        }
+        chunk_queue.close();
+        thread_pool.wait_for_completion();
 
-static void eval_and_update_gradient(parameters_t& gradient, const Entry& entry, const CoefficientEntry* all_coefficients, const parameters_t& params, tune_t K) {
+        for (auto& local_chunks : thread_chunks)
+        {
+            std::move(local_chunks.begin(), local_chunks.end(), back_inserter(parsed_chunks));
+        }
+    }
 
-    const auto* coefficients = all_coefficients + entry.coeff_offset;
-    const auto count = entry.coeff_count;
+    const auto fen_count = merge_parsed_chunks(source, parsed_chunks, deduplicator, entries, entry_infos, all_coefficients);
 
-    // First pass: compute linear eval
-    tune_t score = entry.additional_score;
-#if TAPERED
-    tune_t midgame = 0;
-    tune_t endgame = 0;
-    for (uint16_t ci = 0; ci < count; ci++)
+    print_elapsed(start);
+    std::cout << "Read " << fen_count << " positions from " << source.path << endl;
+}
+
+static void load_dataset(ThreadPool& thread_pool, const vector<DataSource>& sources, const parameters_t& parameters, const high_resolution_clock::time_point start, vector<Entry>& entries, vector<EntryInfo>& entry_infos, vector<CoefficientEntry>& all_coefficients)
+{
+    uint64_t cache_key = 0;
+    if constexpr (enable_dataset_cache)
     {
-        const auto& coefficient = coefficients[ci];
-        midgame += coefficient.value * params[coefficient.index][static_cast<int32_t>(PhaseStages::Midgame)];
-        endgame += coefficient.value * params[coefficient.index][static_cast<int32_t>(PhaseStages::Endgame)];
+        cache_key = DatasetCache::get_key(sources, parameters);
+        if (DatasetCache::load(dataset_cache_path, cache_key, entries, entry_infos, all_coefficients))
+        {
+            print_elapsed(start);
+            cout << "Loaded " << entries.size() << " positions from dataset cache " << dataset_cache_path << endl;
+            return;
+        }
     }
-    score += (midgame * entry.phase + endgame * entry.endgame_scale * (24 - entry.phase)) / 24;
-#else
-    for (uint16_t ci = 0; ci < count; ci++)
+
+    // Shared across sources, the same positions often appear in several of them
     {
-        score += coefficients[ci].value * params[coefficients[ci].index];
+        CoefficientDeduplicator deduplicator;
+        for (const auto& source : sources)
+        {
+            load_fens(thread_pool, source, parameters, start, deduplicator, entries, entry_infos, all_coefficients);
+        }
+        all_coefficients.shrink_to_fit();
+        cout << "Shared coefficients of " << deduplicator.get_shared_count() << " positions with identical earlier positions" << endl;
     }
-#endif
-
-    // Sigmoid + derivative
-    const tune_t sig = sigmoid(K, score);
-    const tune_t res = (entry.wdl - sig) * sig * (1 - sig);
-
-    // Second pass: accumulate gradient (coefficients still in L1)
-#if TAPERED
-    const auto mg_base = res * (entry.phase / static_cast<tune_t>(24));
-    const auto eg_base = (res - mg_base) * entry.endgame_scale;
-#endif
 
-    for (uint16_t ci = 0; ci < count; ci++)
+    if constexpr (enable_dataset_cache)
     {
-        const auto& coefficient = coefficients[ci];
-#if TAPERED
-        gradient[coefficient.index][static_cast<int32_t>(PhaseStages::Midgame)] += mg_base * coefficient.value;
-        gradient[coefficient.index][static_cast<int32_t>(PhaseStages::Endgame)] += eg_base * coefficient.value;
-#else
-        gradient[coefficient.index] += res * coefficient.value;
-#endif
+        cout << "Writing dataset cache " << dataset_cache_path << "..." << endl;
+        DatasetCache::save(dataset_cache_path, cache_key, entries, entry_infos, all_coefficients);
     }
 }
 
-static void compute_gradient(ThreadPool& thread_pool, parameters_t& gradient, array<parameters_t, thread_count>& thread_gradients, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& params, tune_t K)
+// Entries are split into this many chunks per thread, so threads that get cheap entries can take over chunks from the others
+constexpr size_t entry_chunks_per_thread = 4;
+constexpr size_t min_entry_chunk_size = 1024;
+
+// Depends only on the entry count and thread count, so per-chunk sums are combined in the same order on every run
+static size_t get_entry_chunk_size(const size_t entry_count)
+{
+    const auto chunk_count = static_cast<size_t>(thread_count) * entry_chunks_per_thread;
+    return std::max(min_entry_chunk_size, (entry_count + chunk_count - 1) / chunk_count);
+}
+
+// Mini-batches are made of blocks of consecutive entries, so a pass is shuffled by permuting blocks instead of entries
+static size_t get_minibatch_block_size()
 {
-    for(int thread_id = 0; thread_id < thread_count; thread_id++)
+    const auto blocks_per_step = static_cast<size_t>(thread_count) * entry_chunks_per_thread;
+    return std::max(min_entry_chunk_size, static_cast<size_t>(minibatch_size) / blocks_per_step);
+}
+
+// Evaluates each entry once and gets the average error for every K from it, so nearby Ks cost a single pass
+template<size_t KCount>
+static array<tune_t, KCount> get_average_errors(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters, const array<tune_t, KCount>& Ks)
+{
+    const auto chunk_size = get_entry_chunk_size(entries.size());
+    const auto chunk_count = (entries.size() + chunk_size - 1) / chunk_size;
+    vector<array<tune_t, KCount>> chunk_errors(chunk_count);
+    vector<int64_t> chunk_weights(chunk_count);
+    thread_pool.parallel_for(0, entries.size(), chunk_size, [chunk_size, &chunk_errors, &chunk_weights, &entries, all_coefficients, &parameters, &Ks](const size_t start, const size_t end, uint32_t)
     {
-        thread_pool.enqueue([thread_id, &thread_gradients, &entries, all_coefficients, &params, K]()
+        array<PairwiseSum<tune_t>, KCount> errors;
+        int64_t weight = 0;
+        for (size_t i = start; i < end; i++)
         {
-            const auto start = static_cast<int64_t>(thread_id) * entries.size() / thread_count;
-            const auto end = static_cast<int64_t>(thread_id + 1) * entries.size() / thread_count;
-            auto& local_gradient = thread_gradients[thread_id];
-#if TAPERED
-            std::fill(local_gradient.begin(), local_gradient.end(), pair_t{});
-#else
-            std::fill(local_gradient.begin(), local_gradient.end(), static_cast<tune_t>(0));
-#endif
-            for (int64_t i = start; i < end; i++)
+            const auto& entry = entries[i];
+            const auto eval = linear_eval(entry, all_coefficients, parameters);
+            for (size_t k_index = 0; k_index < KCount; k_index++)
             {
-                eval_and_update_gradient(local_gradient, entries[i], all_coefficients, params, K);
+                const auto sig = sigmoid(Ks[k_index], eval);
+                const auto diff = entry.get_wdl() - sig;
+                const auto entry_error = diff * diff * entry.weight;
+                errors[k_index].add(entry_error);
             }
-        });
-    }
-
-    thread_pool.wait_for_completion();
+            weight += entry.weight;
+        }
+        for (size_t k_index = 0; k_index < KCount; k_index++)
+        {
+            chunk_errors[start / chunk_size][k_index] = errors[k_index].get();
+        }
+        chunk_weights[start / chunk_size] = weight;
+    });
 
-    for (int thread_id = 0; thread_id < thread_count; thread_id++)
+    array<PairwiseSum<tune_t>, KCount> total_errors;
+    int64_t total_weight = 0;
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
     {
-        for(auto parameter_index = 0; parameter_index < params.size(); parameter_index++)
+        for (size_t k_index = 0; k_index < KCount; k_index++)
         {
-#if TAPERED
-            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)] += thread_gradients[thread_id][parameter_index][static_cast<int32_t>(PhaseStages::Midgame)];
-            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)] += thread_gradients[thread_id][parameter_index][static_cast<int32_t>(PhaseStages::Endgame)];
-#else
-            gradient[parameter_index] += thread_gradients[thread_id][parameter_index];
-#endif
+            total_errors[k_index].add(chunk_errors[chunk_index][k_index]);
         }
+        total_weight += chunk_weights[chunk_index];
+    }
+
+    array<tune_t, KCount> avg_errors;
+    for (size_t k_index = 0; k_index < KCount; k_index++)
+    {
+        avg_errors[k_index] = total_errors[k_index].get() / static_cast<tune_t>(total_weight);
     }
+    return avg_errors;
 }
 
-void Tuner::run(const std::vector<DataSource>& sources)
+static tune_t get_average_error(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters, tune_t K)
 {
-    cout << "Starting tuning" << endl << endl;
-    const auto start = high_resolution_clock::now();
+    return get_average_errors<1>(thread_pool, entries, all_coefficients, parameters, { K })[0];
+}
 
-    cout << "Starting thread pool..." << endl;
+static vector<tune_t> get_evals(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters)
+{
+    vector<tune_t> evals(entries.size());
+    thread_pool.parallel_for(0, entries.size(), get_entry_chunk_size(entries.size()), [&evals, &entries, all_coefficients, &parameters](const size_t start, const size_t end, uint32_t)
+    {
+        for (size_t i = start; i < end; i++)
+        {
+            evals[i] = linear_eval(entries[i], all_coefficients, parameters);
+        }
+    });
+    return evals;
+}
+
+// First and second derivative of the average error with respect to K, get_eval(i) gives the eval of entries[i]
+template<typename GetEval>
+static pair<tune_t, tune_t> get_k_derivatives(ThreadPool& thread_pool, const vector<Entry>& entries, const GetEval& get_eval, const tune_t K)
+{
+    const auto chunk_size = get_entry_chunk_size(entries.size());
+    const auto chunk_count = (entries.size() + chunk_size - 1) / chunk_size;
+    vector<array<tune_t, 2>> chunk_derivatives(chunk_count);
+    vector<int64_t> chunk_weights(chunk_count);
+    thread_pool.parallel_for(0, entries.size(), chunk_size, [chunk_size, &chunk_derivatives, &chunk_weights, &entries, &get_eval, K](const size_t start, const size_t end, uint32_t)
+    {
+        PairwiseSum<tune_t> first;
+        PairwiseSum<tune_t> second;
+        int64_t weight = 0;
+        for (size_t i = start; i < end; i++)
+        {
+            const auto& entry = entries[i];
+            const auto eval = get_eval(i);
+            // With x = eval / 400 and s = sigmoid(K * x), ds/dK = s * (1 - s) * x
+            const auto x = eval / static_cast<tune_t>(400);
+            const auto sig = sigmoid(K, eval);
+            const auto diff = entry.get_wdl() - sig;
+            const auto slope = sig * (1 - sig) * x;
+            first.add(-2 * diff * slope * entry.weight);
+            second.add(2 * (slope * slope - diff * slope * (1 - 2 * sig) * x) * entry.weight);
+            weight += entry.weight;
+        }
+        chunk_derivatives[start / chunk_size] = { first.get(), second.get() };
+        chunk_weights[start / chunk_size] = weight;
+    });
+
+    PairwiseSum<tune_t> first;
+    PairwiseSum<tune_t> second;
+    int64_t total_weight = 0;
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        first.add(chunk_derivatives[chunk_index][0]);
+        second.add(chunk_derivatives[chunk_index][1]);
+        total_weight += chunk_weights[chunk_index];
+    }
+    return { first.get() / static_cast<tune_t>(total_weight), second.get() / static_cast<tune_t>(total_weight) };
+}
+
+// Newton's method on the derivatives, each iteration is one pass that gets every eval from get_eval.
+// Returns the starting K if the fit doesn't converge, e.g. when the error keeps falling towards K = 0
+template<typename GetEval>
+static tune_t fit_k(ThreadPool& thread_pool, const vector<Entry>& entries, const GetEval& get_eval, const tune_t initial_K)
+{
+    constexpr tune_t fallback_rate = 10;
+    constexpr tune_t step_goal = 1e-6;
+    // Below this the sigmoid is nearly flat over any realistic eval range, the error has no minimum worth following there
+    constexpr tune_t min_k = 1e-3;
+    constexpr int32_t max_iterations = 100;
+
+    tune_t K = initial_K;
+    for (int32_t iteration = 0; iteration < max_iterations; iteration++)
+    {
+        const auto [first, second] = get_k_derivatives(thread_pool, entries, get_eval, K);
+        // Far from the minimum the error can be concave in K, a plain gradient step is taken there instead
+        auto step = second > 0 ? first / second : first * fallback_rate;
+        // A step past zero is cut to halving K, that step shrinks because K does, not because the fit converged
+        const bool clamped = K - step <= 0;
+        if (clamped)
+        {
+            step = K / 2;
+        }
+        cout << "Current K: " << K << ", derivative: " << first << ", second derivative: " << second << endl;
+        K -= step;
+        if (!clamped && fabs(step) < step_goal)
+        {
+            return K;
+        }
+        if (K < min_k)
+        {
+            break;
+        }
+    }
+
+    cout << "Warning: K did not converge (reached " << K << "), keeping K = " << initial_K << endl;
+    return initial_K;
+}
+
+static tune_t find_optimal_k(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters)
+{
+    tune_t K = 2.5;
+    if (k_sample_size > 0 && entries.size() > static_cast<size_t>(k_sample_size))
+    {
+        // The fit on the sample is close enough that the full set usually only needs a confirming iteration or two
+        constexpr uint64_t k_sample_seed = 1;
+        mt19937_64 random(k_sample_seed);
+        vector<Entry> sample;
+        sample.reserve(k_sample_size);
+        std::sample(entries.begin(), entries.end(), back_inserter(sample), k_sample_size, random);
+        // The evals don't depend on K, so the sample's are computed once and kept for every iteration
+        const auto evals = get_evals(thread_pool, sample, all_coefficients, parameters);
+        K = fit_k(thread_pool, sample, [&evals](const size_t i)
+        {
+            return evals[i];
+        }, K);
+        cout << "K on " << sample.size() << " sampled positions: " << K << ", confirming on all positions" << endl;
+    }
+
+    // Keeping an eval per position of the full set would take as much memory as the entries, each iteration evaluates them again instead
+    return fit_k(thread_pool, entries, [&entries, all_coefficients, &parameters](const size_t i)
+    {
+        return linear_eval(entries[i], all_coefficients, parameters);
+    }, K);
+}
+
+// Calls add(column, value) for every coefficient of the entry weighted by its phase, one column per parameter and phase as in flatten_parameters
+template<typename Callback>
+static void for_each_phase_coefficient(const Entry& entry, const CoefficientEntry* all_coefficients, const Callback& add)
+{
+    for_each_coefficient(entry, all_coefficients, [&entry, &add](const CoefficientEntry coefficient, const int16_t raw_value)
+    {
+        const auto index = static_cast<size_t>(coefficient.get_index());
+        const auto value = static_cast<double>(raw_value);
+#if TAPERED
+        add(index * 2, value * entry.phase / 24.0);
+        add(index * 2 + 1, value * static_cast<double>(entry.get_endgame_scale()) * (24 - entry.phase) / 24.0);
+#else
+        add(index, value);
+#endif
+    });
+}
+
+// Sums a vector over all entries. Each chunk of entries sums into its own vector and the chunks are added in order,
+// so the result doesn't depend on which worker ran which chunk.
+template<typename AddEntry>
+static void sum_over_entries(ThreadPool& thread_pool, const vector<Entry>& entries, vector<vector<double>>& chunk_sums, vector<double>& total, const AddEntry& add_entry)
+{
+    const auto chunk_size = get_entry_chunk_size(entries.size());
+    chunk_sums.resize((entries.size() + chunk_size - 1) / chunk_size);
+    const auto size = total.size();
+    thread_pool.parallel_for(0, entries.size(), chunk_size, [chunk_size, size, &chunk_sums, &entries, &add_entry](const size_t start, const size_t end, uint32_t)
+    {
+        auto& sum = chunk_sums[start / chunk_size];
+        sum.assign(size, 0);
+        for (size_t i = start; i < end; i++)
+        {
+            add_entry(entries[i], sum);
+        }
+    });
+
+    constexpr size_t grain = 1024;
+    thread_pool.parallel_for(0, size, grain, [&chunk_sums, &total](const size_t begin, const size_t end, uint32_t)
+    {
+        for (size_t column = begin; column < end; column++)
+        {
+            double value = 0;
+            for (const auto& sum : chunk_sums)
+            {
+                value += sum[column];
+            }
+            total[column] = value;
+        }
+    });
+}
+
+static double dot(const vector<double>& left, const vector<double>& right)
+{
+    double sum = 0;
+    for (size_t i = 0; i < left.size(); i++)
+    {
+        sum += left[i] * right[i];
+    }
+    return sum;
+}
+
+// Fits the eval to the logit of the clipped wdl with linear least squares, as a starting point that is already on the right scale.
+// The ridge term pulls towards the current parameters, so parameters that never appear keep their value.
+// The normal equations are solved with Jacobi preconditioned conjugate gradients on products with the design matrix, so memory stays
+// linear in the parameter count instead of holding the (2P)x(2P) normal matrix. Every iteration is one pass over the entries.
+static void warm_start_parameters(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, parameters_t& parameters, const tune_t K)
+{
+    const auto size = parameters.size() * phase_count;
+    vector<vector<double>> chunk_sums;
+
+    // Right hand side A^T W t and the diagonal of A^T W A, side by side in one vector
+    vector<double> targets_and_diagonal(size * 2);
+    sum_over_entries(thread_pool, entries, chunk_sums, targets_and_diagonal, [all_coefficients, size, K](const Entry& entry, vector<double>& sum)
+    {
+        const auto wdl = std::clamp(static_cast<double>(entry.get_wdl()), warm_start_wdl_clip, 1 - warm_start_wdl_clip);
+        const auto target = log(wdl / (1 - wdl)) * 400 / K - entry.additional_score;
+        for_each_phase_coefficient(entry, all_coefficients, [&sum, &entry, size, target](const size_t column, const double value)
+        {
+            const auto weighted_value = value * entry.weight;
+            sum[column] += weighted_value * target;
+            sum[size + column] += weighted_value * value;
+        });
+    });
+
+    vector<double> targets(targets_and_diagonal.begin(), targets_and_diagonal.begin() + size);
+    vector<double> diagonal(targets_and_diagonal.begin() + size, targets_and_diagonal.end());
+    double trace = 0;
+    for (const auto value : diagonal)
+    {
+        trace += value;
+    }
+    const auto ridge = std::max(warm_start_ridge * trace / static_cast<double>(size), 1e-12);
+
+    vector<double> solution(size);
+    for (size_t parameter_index = 0; parameter_index < parameters.size(); parameter_index++)
+    {
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            solution[parameter_index * phase_count + phase] = get_phase_value(parameters[parameter_index], phase);
+        }
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        targets[i] += ridge * solution[i];
+    }
+
+    // (A^T W A + ridge) x, the design matrix is only ever applied one entry row at a time
+    vector<double> product(size);
+    const auto multiply = [&](const vector<double>& direction)
+    {
+        sum_over_entries(thread_pool, entries, chunk_sums, product, [all_coefficients, &direction](const Entry& entry, vector<double>& sum)
+        {
+            double row_product = 0;
+            for_each_phase_coefficient(entry, all_coefficients, [&row_product, &direction](const size_t column, const double value)
+            {
+                row_product += value * direction[column];
+            });
+            row_product *= entry.weight;
+            for_each_phase_coefficient(entry, all_coefficients, [&sum, row_product](const size_t column, const double value)
+            {
+                sum[column] += value * row_product;
+            });
+        });
+        for (size_t i = 0; i < size; i++)
+        {
+            product[i] += ridge * direction[i];
+        }
+    };
+
+    // Starting from the current parameters, the residual is what the fit still has to change
+    multiply(solution);
+    vector<double> residual(size);
+    vector<double> preconditioned(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        residual[i] = targets[i] - product[i];
+        preconditioned[i] = residual[i] / (diagonal[i] + ridge);
+    }
+    auto direction = preconditioned;
+    auto residual_dot = dot(residual, preconditioned);
+    const auto target_norm = sqrt(dot(targets, targets));
+
+    int32_t iteration = 0;
+    double residual_norm = sqrt(dot(residual, residual));
+    for (; iteration < warm_start_max_iterations && residual_norm > warm_start_tolerance * target_norm; iteration++)
+    {
+        multiply(direction);
+        const auto step = residual_dot / dot(direction, product);
+        for (size_t i = 0; i < size; i++)
+        {
+            solution[i] += step * direction[i];
+            residual[i] -= step * product[i];
+            preconditioned[i] = residual[i] / (diagonal[i] + ridge);
+        }
+
+        const auto next_residual_dot = dot(residual, preconditioned);
+        const auto direction_scale = next_residual_dot / residual_dot;
+        residual_dot = next_residual_dot;
+        for (size_t i = 0; i < size; i++)
+        {
+            direction[i] = preconditioned[i] + direction_scale * direction[i];
+        }
+        residual_norm = sqrt(dot(residual, residual));
+    }
+
+    if (residual_norm > warm_start_tolerance * target_norm)
+    {
+        cout << "Warning: warm start stopped after " << iteration << " iterations with relative residual " << residual_norm / target_norm << endl;
+    }
+    else
+    {
+        cout << "Warm start converged after " << iteration << " iterations" << endl;
+    }
+
+    for (size_t parameter_index = 0; parameter_index < parameters.size(); parameter_index++)
+    {
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            get_phase_value(parameters[parameter_index], phase) = static_cast<tune_t>(solution[parameter_index * phase_count + phase]);
+        }
+    }
+}
+
+// Copies each worker's share of the entries, and the coefficients they use, into memory first touched by that worker.
+// The OS places a page on the NUMA node of the thread that touches it first, so every worker reads its share from local memory.
+// Coefficient runs shared between workers are replicated, runs shared within a share stay shared.
+static void place_dataset_on_workers(ThreadPool& thread_pool, vector<Entry>& entries, vector<CoefficientEntry>& all_coefficients)
+{
+    const auto worker_count = thread_pool.thread_count();
+    const auto chunk_size = get_entry_chunk_size(entries.size());
+    vector<unordered_map<uint32_t, uint32_t>> worker_offsets(worker_count);
+    vector<size_t> worker_coefficient_counts(worker_count);
+    thread_pool.run_on_each_worker([&](const uint32_t worker_index)
+    {
+        const auto [share_begin, share_end] = thread_pool.get_worker_share(0, entries.size(), chunk_size, worker_index);
+        auto& offsets = worker_offsets[worker_index];
+        size_t coefficient_count = 0;
+        for (auto entry_index = share_begin; entry_index < share_end; entry_index++)
+        {
+            const auto& entry = entries[entry_index];
+            if (offsets.try_emplace(entry.coeff_offset, static_cast<uint32_t>(coefficient_count)).second)
+            {
+                coefficient_count += get_coefficient_run_size(all_coefficients.data() + entry.coeff_offset, entry.coeff_count);
+            }
+        }
+        worker_coefficient_counts[worker_index] = coefficient_count;
+    });
+
+    vector<size_t> worker_coefficient_bases(worker_count);
+    size_t total_coefficient_count = 0;
+    for (uint32_t worker_index = 0; worker_index < worker_count; worker_index++)
+    {
+        worker_coefficient_bases[worker_index] = total_coefficient_count;
+        total_coefficient_count += worker_coefficient_counts[worker_index];
+    }
+    if (total_coefficient_count > UINT32_MAX)
+    {
+        throw runtime_error("Too many coefficients to place per worker");
+    }
+
+    // Neither element type initializes itself, so these stay untouched until the workers fill them
+    vector<Entry> placed_entries(entries.size());
+    vector<CoefficientEntry> placed_coefficients(total_coefficient_count);
+    thread_pool.run_on_each_worker([&](const uint32_t worker_index)
+    {
+        const auto [share_begin, share_end] = thread_pool.get_worker_share(0, entries.size(), chunk_size, worker_index);
+        const auto& offsets = worker_offsets[worker_index];
+        const auto base = worker_coefficient_bases[worker_index];
+        for (auto entry_index = share_begin; entry_index < share_end; entry_index++)
+        {
+            auto entry = entries[entry_index];
+            const auto local_offset = offsets.at(entry.coeff_offset);
+            const auto* coefficients = all_coefficients.data() + entry.coeff_offset;
+            copy_n(coefficients, get_coefficient_run_size(coefficients, entry.coeff_count), placed_coefficients.data() + base + local_offset);
+            entry.coeff_offset = static_cast<uint32_t>(base + local_offset);
+            placed_entries[entry_index] = entry;
+        }
+    });
+
+    entries.swap(placed_entries);
+    all_coefficients.swap(placed_coefficients);
+}
+
+// Single precision gradients are summed per block of entries, blocks are then combined pairwise.
+// The block size bounds how many float additions each gradient element takes before it is folded into the pairwise sum.
+constexpr size_t gradient_block_size = 4096;
+
+struct EntryRange
+{
+    size_t begin;
+    size_t end;
+    int64_t weight;
+};
+
+static vector<EntryRange> get_entry_ranges(const vector<Entry>& entries, const size_t range_size)
+{
+    vector<EntryRange> ranges;
+    for (size_t begin = 0; begin < entries.size(); begin += range_size)
+    {
+        EntryRange range{ begin, std::min(begin + range_size, entries.size()), 0 };
+        for (auto entry_index = range.begin; entry_index < range.end; entry_index++)
+        {
+            range.weight += entries[entry_index].weight;
+        }
+        ranges.push_back(range);
+    }
+    return ranges;
+}
+
+struct GradientWorkspace
+{
+    GradientKernel kernel;
+    SplitParameters parameters;
+    vector<SplitParameters> chunk_gradients;
+    vector<tune_t> chunk_errors;
+
+    // Sparse steps only: the parameters each chunk slot's gradient is nonzero for, and their union over the step
+    vector<vector<uint32_t>> chunk_touched;
+    array<vector<uint64_t>, thread_count> thread_stamps;
+    vector<uint64_t> parameter_stamps;
+    vector<uint32_t> touched;
+    uint64_t sparse_step = 0;
+    bool parameters_stale = true;
+
+    // Column-major gradients only: the parameter columns and every entry's residual from the row pass
+    CoefficientColumns columns;
+    vector<EntryResidual> residuals;
+#if SINGLE_PRECISION
+    array<SplitParameters, thread_count> thread_blocks;
+    array<PairwiseGradientSum, thread_count> thread_sums;
+#endif
+
+    void resize(const size_t parameter_count, const size_t max_chunk_count)
+    {
+        parameters.resize(parameter_count);
+        chunk_gradients.resize(max_chunk_count);
+        chunk_errors.resize(max_chunk_count);
+        chunk_touched.resize(max_chunk_count);
+        for (auto& thread_stamp : thread_stamps)
+        {
+            thread_stamp.assign(parameter_count, 0);
+        }
+        parameter_stamps.assign(parameter_count, 0);
+        // The column pass writes the gradient directly, chunks only need their error
+        if constexpr (column_major_gradient)
+        {
+            return;
+        }
+        for (auto& chunk_gradient : chunk_gradients)
+        {
+            chunk_gradient.resize(parameter_count);
+        }
+#if SINGLE_PRECISION
+        for (auto& thread_block : thread_blocks)
+        {
+            thread_block.resize(parameter_count);
+        }
+#endif
+    }
+};
+
+// Parameters per reduction task, small evals are reduced by a single worker
+constexpr size_t min_reduction_grain = 256;
+
+// Adds up the chunk gradients with a pairwise tree over the chunk slots, in parallel over ranges of parameters.
+// The tree only depends on the chunk count, so the sum doesn't depend on which worker reduces which range. Overwrites the chunk gradients.
+static void reduce_chunk_gradients(ThreadPool& thread_pool, vector<SplitParameters>& chunk_gradients, const size_t chunk_count, parameters_t& gradient)
+{
+    if (chunk_count == 0)
+    {
+        return;
+    }
+
+    const auto parameter_count = gradient.size();
+    const auto grain = std::max(min_reduction_grain, (parameter_count + thread_count - 1) / thread_count);
+    thread_pool.parallel_for(0, parameter_count, grain, [&chunk_gradients, chunk_count, &gradient](const size_t begin, const size_t end, uint32_t)
+    {
+        for (size_t stride = 1; stride < chunk_count; stride *= 2)
+        {
+            for (size_t chunk_index = 0; chunk_index + stride < chunk_count; chunk_index += 2 * stride)
+            {
+                auto& target = chunk_gradients[chunk_index];
+                const auto& source = chunk_gradients[chunk_index + stride];
+                for (size_t parameter_index = begin; parameter_index < end; parameter_index++)
+                {
+                    target.midgame[parameter_index] += source.midgame[parameter_index];
+#if TAPERED
+                    target.endgame[parameter_index] += source.endgame[parameter_index];
+#endif
+                }
+            }
+        }
+
+        const auto& total = chunk_gradients[0];
+        for (size_t parameter_index = begin; parameter_index < end; parameter_index++)
+        {
+#if TAPERED
+            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)] += total.midgame[parameter_index];
+            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)] += total.endgame[parameter_index];
+#else
+            gradient[parameter_index] += total.midgame[parameter_index];
+#endif
+        }
+    });
+}
+
+// Columns per task of the column pass, material columns are as long as the dataset so small tasks keep the workers balanced
+constexpr size_t column_tasks_per_thread = 16;
+
+// Columns can be as long as the dataset, too long to sum in order in single precision
+#if SINGLE_PRECISION
+using ColumnSum = PairwiseSum<tune_t>;
+#else
+class ColumnSum
+{
+public:
+    void add(const tune_t value)
+    {
+        sum += value;
+    }
+
+    tune_t get() const
+    {
+        return sum;
+    }
+
+private:
+    tune_t sum = 0;
+};
+#endif
+
+// Gradient in two passes without per-chunk gradients: a row pass stores the residual of every entry,
+// then every parameter sums its column. Each parameter is summed by one task in entry order, so there is nothing to reduce.
+static tune_t compute_column_gradient(ThreadPool& thread_pool, GradientWorkspace& workspace, parameters_t& gradient, const EntryRange* chunks, const size_t chunk_count, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& params, tune_t K)
+{
+    workspace.parameters.assign(params);
+    workspace.parameters_stale = true;
+
+    const auto encoding = coefficient_values.get_encoding();
+    thread_pool.parallel_for(0, chunk_count, 1, [&workspace, chunks, &entries, all_coefficients, K, encoding](const size_t chunk_index, size_t, uint32_t)
+    {
+        const auto start = chunks[chunk_index].begin;
+        const auto end = chunks[chunk_index].end;
+        workspace.chunk_errors[chunk_index] = compute_entry_residuals(entries.data() + start, end - start, all_coefficients, workspace.parameters, workspace.residuals.data() + start, K, encoding);
+    });
+
+    const auto& columns = workspace.columns;
+    const auto* residuals = workspace.residuals.data();
+    const auto grain = std::max(static_cast<size_t>(1), params.size() / (static_cast<size_t>(thread_count) * column_tasks_per_thread));
+    thread_pool.parallel_for(0, params.size(), grain, [&columns, residuals, &gradient](const size_t begin, const size_t end, uint32_t)
+    {
+        for (size_t parameter_index = begin; parameter_index < end; parameter_index++)
+        {
+            ColumnSum midgame;
+            [[maybe_unused]] ColumnSum endgame;
+            for (auto cell = columns.column_offsets[parameter_index]; cell < columns.column_offsets[parameter_index + 1]; cell++)
+            {
+                const auto& residual = residuals[columns.entry_indices[cell]];
+                const auto value = static_cast<tune_t>(columns.values[cell]);
+                midgame.add(residual.midgame * value);
+#if TAPERED
+                endgame.add(residual.endgame * value);
+#endif
+            }
+#if TAPERED
+            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Midgame)] += midgame.get();
+            gradient[parameter_index][static_cast<int32_t>(PhaseStages::Endgame)] += endgame.get();
+#else
+            gradient[parameter_index] += midgame.get();
+#endif
+        }
+    });
+
+    PairwiseSum<tune_t> total_error;
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        total_error.add(workspace.chunk_errors[chunk_index]);
+    }
+    return total_error.get();
+}
+
+// Adds the gradient of the entries in the given chunks, one parallel task per chunk.
+// Returns their weighted squared error, measured at the parameters the gradient was computed at.
+static tune_t compute_gradient(ThreadPool& thread_pool, GradientWorkspace& workspace, parameters_t& gradient, const EntryRange* chunks, const size_t chunk_count, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& params, tune_t K)
+{
+    if constexpr (column_major_gradient)
+    {
+        return compute_column_gradient(thread_pool, workspace, gradient, chunks, chunk_count, entries, all_coefficients, params, K);
+    }
+
+    workspace.parameters.assign(params);
+    workspace.parameters_stale = true;
+
+    thread_pool.parallel_for(0, chunk_count, 1, [&workspace, chunks, &entries, all_coefficients, &params, K](const size_t chunk_index, size_t, [[maybe_unused]] const uint32_t worker_index)
+    {
+        const auto start = chunks[chunk_index].begin;
+        const auto end = chunks[chunk_index].end;
+        auto& local_gradient = workspace.chunk_gradients[chunk_index];
+#if SINGLE_PRECISION
+        auto& block_gradient = workspace.thread_blocks[worker_index];
+        auto& gradient_sum = workspace.thread_sums[worker_index];
+        gradient_sum.reset(params.size());
+        PairwiseSum<tune_t> error_sum;
+        for (auto block_start = start; block_start < end; block_start += gradient_block_size)
+        {
+            block_gradient.zero();
+            error_sum.add(workspace.kernel(entries.data() + block_start, std::min(gradient_block_size, end - block_start), all_coefficients, workspace.parameters, block_gradient, K));
+            gradient_sum.add(block_gradient);
+        }
+        gradient_sum.get_total(local_gradient);
+        workspace.chunk_errors[chunk_index] = error_sum.get();
+#else
+        local_gradient.zero();
+        workspace.chunk_errors[chunk_index] = workspace.kernel(entries.data() + start, end - start, all_coefficients, workspace.parameters, local_gradient, K);
+#endif
+    });
+
+    PairwiseSum<tune_t> total_error;
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        total_error.add(workspace.chunk_errors[chunk_index]);
+    }
+
+    reduce_chunk_gradients(thread_pool, workspace.chunk_gradients, chunk_count, gradient);
+    return total_error.get();
+}
+
+// Like compute_gradient, but only touches the parameters the chunks' coefficients refer to, collected into workspace.touched.
+// Expects gradient to be zero everywhere except at the previous step's touched parameters, and the parameters to have changed only there.
+static tune_t compute_sparse_gradient(ThreadPool& thread_pool, GradientWorkspace& workspace, parameters_t& gradient, const EntryRange* chunks, const size_t chunk_count, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& params, tune_t K)
+{
+    if (workspace.parameters_stale)
+    {
+        workspace.parameters.assign(params);
+        for (auto& chunk_gradient : workspace.chunk_gradients)
+        {
+            chunk_gradient.zero();
+        }
+        for (auto& chunk_touched : workspace.chunk_touched)
+        {
+            chunk_touched.clear();
+        }
+        workspace.parameters_stale = false;
+    }
+    else
+    {
+        workspace.parameters.assign(params, workspace.touched);
+    }
+
+    workspace.sparse_step++;
+    thread_pool.parallel_for(0, chunk_count, 1, [&workspace, chunks, &entries, all_coefficients, K](const size_t chunk_index, size_t, const uint32_t worker_index)
+    {
+        const auto start = chunks[chunk_index].begin;
+        const auto end = chunks[chunk_index].end;
+        auto& local_gradient = workspace.chunk_gradients[chunk_index];
+        auto& touched = workspace.chunk_touched[chunk_index];
+        local_gradient.zero(touched);
+        touched.clear();
+
+        // Stamps are unique per step and chunk slot, so the per-worker array never needs clearing
+        auto& stamps = workspace.thread_stamps[worker_index];
+        const auto stamp = workspace.sparse_step * workspace.chunk_gradients.size() + chunk_index + 1;
+        for (auto entry_index = start; entry_index < end; entry_index++)
+        {
+            for_each_coefficient(entries[entry_index], all_coefficients, [&stamps, &touched, stamp](const CoefficientEntry coefficient, int16_t)
+            {
+                const auto parameter_index = coefficient.get_index();
+                if (stamps[parameter_index] != stamp)
+                {
+                    stamps[parameter_index] = stamp;
+                    touched.push_back(parameter_index);
+                }
+            });
+        }
+
+        workspace.chunk_errors[chunk_index] = workspace.kernel(entries.data() + start, end - start, all_coefficients, workspace.parameters, local_gradient, K);
+    });
+
+    PairwiseSum<tune_t> total_error;
+    workspace.touched.clear();
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        total_error.add(workspace.chunk_errors[chunk_index]);
+        const auto& chunk_touched = workspace.chunk_touched[chunk_index];
+        workspace.chunk_gradients[chunk_index].add_to(gradient, chunk_touched);
+        for (const auto parameter_index : chunk_touched)
+        {
+            if (workspace.parameter_stamps[parameter_index] != workspace.sparse_step)
+            {
+                workspace.parameter_stamps[parameter_index] = workspace.sparse_step;
+                workspace.touched.push_back(parameter_index);
+            }
+        }
+    }
+
+    return total_error.get();
+}
+
+struct AdamState
+{
+    parameters_t momentum;
+    parameters_t velocity;
+    tune_t beta1_power = 1;
+    tune_t beta2_power = 1;
+};
+
+constexpr tune_t adam_beta1 = 0.9;
+constexpr tune_t adam_beta2 = 0.999;
+
+// One Adam update from a gradient summed over entries with the given total weight.
+// With a ParameterCount from the eval, the loop has a fixed trip count the compiler can unroll and vectorize.
+template<size_t ParameterCount = static_parameter_count>
+static void adam_step(AdamState& state, parameters_t& parameters, const parameters_t& gradient, const int64_t gradient_weight, const tune_t K, const tune_t learning_rate)
+{
+    auto& momentum = state.momentum;
+    auto& velocity = state.velocity;
+    constexpr tune_t beta1 = adam_beta1;
+    constexpr tune_t beta2 = adam_beta2;
+
+    state.beta1_power *= beta1;
+    state.beta2_power *= beta2;
+    tune_t bias_correction1 = 1;
+    tune_t bias_correction2 = 1;
+    if constexpr (TuneEval::adam_bias_correction)
+    {
+        bias_correction1 = 1 - state.beta1_power;
+        bias_correction2 = 1 - state.beta2_power;
+    }
+
+    const size_t parameter_count = ParameterCount > 0 ? ParameterCount : parameters.size();
+    for (size_t parameter_index = 0; parameter_index < parameter_count; parameter_index++)
+    {
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            const tune_t grad = -K / static_cast<tune_t>(400) * get_phase_value(gradient[parameter_index], phase) / static_cast<tune_t>(gradient_weight);
+            auto& parameter_momentum = get_phase_value(momentum[parameter_index], phase);
+            auto& parameter_velocity = get_phase_value(velocity[parameter_index], phase);
+            parameter_momentum = beta1 * parameter_momentum + (1 - beta1) * grad;
+            parameter_velocity = beta2 * parameter_velocity + (1 - beta2) * grad * grad;
+            const tune_t corrected_momentum = parameter_momentum / bias_correction1;
+            const tune_t corrected_velocity = parameter_velocity / bias_correction2;
+            get_phase_value(parameters[parameter_index], phase) -= learning_rate * corrected_momentum / (static_cast<tune_t>(1e-8) + sqrt(corrected_velocity));
+        }
+    }
+}
+
+// Adam step over the touched parameters only. A parameter skipped for some steps first gets the momentum and velocity decay of
+// those steps, as if its gradient had been zero, but doesn't move during them. The gradient of the touched parameters is zeroed.
+static void sparse_adam_step(AdamState& state, vector<int64_t>& last_steps, const int64_t step, parameters_t& parameters, parameters_t& gradient, const vector<uint32_t>& touched, const int64_t gradient_weight, const tune_t K, const tune_t learning_rate)
+{
+    auto& momentum = state.momentum;
+    auto& velocity = state.velocity;
+    constexpr tune_t beta1 = adam_beta1;
+    constexpr tune_t beta2 = adam_beta2;
+
+    state.beta1_power *= beta1;
+    state.beta2_power *= beta2;
+    tune_t bias_correction1 = 1;
+    tune_t bias_correction2 = 1;
+    if constexpr (TuneEval::adam_bias_correction)
+    {
+        bias_correction1 = 1 - state.beta1_power;
+        bias_correction2 = 1 - state.beta2_power;
+    }
+
+    for (const auto parameter_index : touched)
+    {
+        const auto skipped_steps = static_cast<tune_t>(step - last_steps[parameter_index] - 1);
+        last_steps[parameter_index] = step;
+        const tune_t momentum_decay = skipped_steps > 0 ? pow(beta1, skipped_steps) : static_cast<tune_t>(1);
+        const tune_t velocity_decay = skipped_steps > 0 ? pow(beta2, skipped_steps) : static_cast<tune_t>(1);
+
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            auto& parameter_gradient = get_phase_value(gradient[parameter_index], phase);
+            const tune_t grad = -K / static_cast<tune_t>(400) * parameter_gradient / static_cast<tune_t>(gradient_weight);
+            parameter_gradient = 0;
+            auto& parameter_momentum = get_phase_value(momentum[parameter_index], phase);
+            auto& parameter_velocity = get_phase_value(velocity[parameter_index], phase);
+            parameter_momentum = beta1 * parameter_momentum * momentum_decay + (1 - beta1) * grad;
+            parameter_velocity = beta2 * parameter_velocity * velocity_decay + (1 - beta2) * grad * grad;
+            const tune_t corrected_momentum = parameter_momentum / bias_correction1;
+            const tune_t corrected_velocity = parameter_velocity / bias_correction2;
+            get_phase_value(parameters[parameter_index], phase) -= learning_rate * corrected_momentum / (static_cast<tune_t>(1e-8) + sqrt(corrected_velocity));
+        }
+    }
+}
+
+static void zero_gradient(parameters_t& gradient)
+{
+    // Zero gradient without reallocating
+    std::fill(gradient.begin(), gradient.end(), parameters_t::value_type{});
+}
+
+// Parameters as one flat vector, with the midgame and endgame values of a parameter next to each other
+static void flatten_parameters(const parameters_t& parameters, vector<tune_t>& values)
+{
+    values.clear();
+    for (const auto& parameter : parameters)
+    {
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            values.push_back(get_phase_value(parameter, phase));
+        }
+    }
+}
+
+static void unflatten_parameters(const vector<tune_t>& values, parameters_t& parameters)
+{
+    for (size_t parameter_index = 0; parameter_index < parameters.size(); parameter_index++)
+    {
+        for (int32_t phase = 0; phase < phase_count; phase++)
+        {
+            get_phase_value(parameters[parameter_index], phase) = values[parameter_index * phase_count + phase];
+        }
+    }
+}
+
+static tune_t dot_product(const vector<tune_t>& left, const vector<tune_t>& right)
+{
+    tune_t sum = 0;
+    for (size_t i = 0; i < left.size(); i++)
+    {
+        sum += left[i] * right[i];
+    }
+    return sum;
+}
+
+// The eval is linear in the parameters, so the eval at parameters + step * direction is the eval at the parameters
+// plus step times the eval of the direction. One pass computes both per entry and gets the error of every step length from them.
+template<size_t StepCount>
+static array<tune_t, StepCount> get_line_errors(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters, const parameters_t& direction, const tune_t K, const array<tune_t, StepCount>& steps)
+{
+    const auto chunk_size = get_entry_chunk_size(entries.size());
+    const auto chunk_count = (entries.size() + chunk_size - 1) / chunk_size;
+    vector<array<tune_t, StepCount>> chunk_errors(chunk_count);
+    vector<int64_t> chunk_weights(chunk_count);
+    thread_pool.parallel_for(0, entries.size(), chunk_size, [chunk_size, &chunk_errors, &chunk_weights, &entries, all_coefficients, &parameters, &direction, K, &steps](const size_t start, const size_t end, uint32_t)
+    {
+        array<PairwiseSum<tune_t>, StepCount> errors;
+        int64_t weight = 0;
+        for (size_t i = start; i < end; i++)
+        {
+            const auto& entry = entries[i];
+            const auto eval = linear_eval(entry, all_coefficients, parameters);
+            const auto slope = linear_eval(entry, all_coefficients, direction) - entry.additional_score;
+            for (size_t step_index = 0; step_index < StepCount; step_index++)
+            {
+                const auto sig = sigmoid(K, eval + steps[step_index] * slope);
+                const auto diff = entry.get_wdl() - sig;
+                errors[step_index].add(diff * diff * entry.weight);
+            }
+            weight += entry.weight;
+        }
+        for (size_t step_index = 0; step_index < StepCount; step_index++)
+        {
+            chunk_errors[start / chunk_size][step_index] = errors[step_index].get();
+        }
+        chunk_weights[start / chunk_size] = weight;
+    });
+
+    array<PairwiseSum<tune_t>, StepCount> total_errors;
+    int64_t total_weight = 0;
+    for (size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        for (size_t step_index = 0; step_index < StepCount; step_index++)
+        {
+            total_errors[step_index].add(chunk_errors[chunk_index][step_index]);
+        }
+        total_weight += chunk_weights[chunk_index];
+    }
+
+    array<tune_t, StepCount> line_errors;
+    for (size_t step_index = 0; step_index < StepCount; step_index++)
+    {
+        line_errors[step_index] = total_errors[step_index].get() / static_cast<tune_t>(total_weight);
+    }
+    return line_errors;
+}
+
+// Inverse of the Gauss-Newton approximation of the error's Hessian diagonal, in the flattened parameter layout.
+// Parameters that no entry uses get 0, their gradient is 0 as well.
+static vector<tune_t> get_inverse_gauss_newton_diagonal(ThreadPool& thread_pool, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, const parameters_t& parameters, const tune_t K, const int64_t total_weight)
+{
+    vector<vector<double>> chunk_sums;
+    vector<double> diagonal(parameters.size() * phase_count);
+    sum_over_entries(thread_pool, entries, chunk_sums, diagonal, [all_coefficients, &parameters, K](const Entry& entry, vector<double>& sum)
+    {
+        // d sigmoid / d eval, squared, is the curvature the entry adds along each of its coefficients
+        const auto sig = static_cast<double>(sigmoid(K, linear_eval(entry, all_coefficients, parameters)));
+        const auto slope = sig * (1 - sig) * K / 400;
+        const auto curvature = 2 * slope * slope * entry.weight;
+        for_each_phase_coefficient(entry, all_coefficients, [&sum, curvature](const size_t column, const double value)
+        {
+            sum[column] += curvature * value * value;
+        });
+    });
+
+    vector<tune_t> inverse_diagonal(diagonal.size());
+    for (size_t i = 0; i < diagonal.size(); i++)
+    {
+        inverse_diagonal[i] = diagonal[i] > 0 ? static_cast<tune_t>(total_weight / diagonal[i]) : 0;
+    }
+    return inverse_diagonal;
+}
+
+struct LbfgsPair
+{
+    vector<tune_t> parameter_change;
+    vector<tune_t> gradient_change;
+    tune_t rho;
+};
+
+// Sufficient decrease a line search step needs, relative to the decrease the gradient predicts
+constexpr tune_t lbfgs_armijo_factor = 1e-4;
+// How much the slope along the direction has to flatten at an accepted trial step, the usual value for quasi-Newton methods
+constexpr tune_t lbfgs_curvature_factor = 0.9;
+constexpr int32_t lbfgs_max_line_searches = 4;
+
+// Minimizes the full batch error with L-BFGS, returns the number of passes over the data it took
+static int32_t run_lbfgs(ThreadPool& thread_pool, GradientWorkspace& workspace, const vector<EntryRange>& chunks, const vector<Entry>& entries, const CoefficientEntry* all_coefficients, parameters_t& parameters, const tune_t K, const int64_t total_weight, const high_resolution_clock::time_point start)
+{
+    const auto loop_start = high_resolution_clock::now();
+    int32_t pass_count = 0;
+    parameters_t gradient = parameters;
+    parameters_t direction_parameters = parameters;
+
+    // Gradient of the average error itself, the Adam steps drop the constant factors
+    const auto get_gradient = [&](vector<tune_t>& flat_gradient)
+    {
+        zero_gradient(gradient);
+        const auto error_sum = compute_gradient(thread_pool, workspace, gradient, chunks.data(), chunks.size(), entries, all_coefficients, parameters, K);
+        pass_count++;
+        flatten_parameters(gradient, flat_gradient);
+        const tune_t scale = -2 * K / static_cast<tune_t>(400) / static_cast<tune_t>(total_weight);
+        for (auto& value : flat_gradient)
+        {
+            value *= scale;
+        }
+        return error_sum / static_cast<tune_t>(total_weight);
+    };
+
+    vector<tune_t> values;
+    vector<tune_t> flat_gradient;
+    vector<tune_t> previous_gradient;
+    flatten_parameters(parameters, values);
+    tune_t error = get_gradient(flat_gradient);
+
+    const auto inverse_diagonal = get_inverse_gauss_newton_diagonal(thread_pool, entries, all_coefficients, parameters, K, total_weight);
+    pass_count++;
+
+    deque<LbfgsPair> history;
+    vector<tune_t> direction(values.size());
+    vector<tune_t> trial_values(values.size());
+    tune_t trial_step = 1;
+    vector<tune_t> alphas(lbfgs_history);
+    for (int32_t iteration = 1; pass_count < TuneEval::max_epoch; iteration++)
+    {
+        // Two-loop recursion for the direction -H * gradient
+        direction = flat_gradient;
+        for (int32_t pair_index = static_cast<int32_t>(history.size()) - 1; pair_index >= 0; pair_index--)
+        {
+            const auto& pair = history[pair_index];
+            alphas[pair_index] = pair.rho * dot_product(pair.parameter_change, direction);
+            for (size_t i = 0; i < direction.size(); i++)
+            {
+                direction[i] -= alphas[pair_index] * pair.gradient_change[i];
+            }
+        }
+
+        // The initial inverse Hessian is the inverse Gauss-Newton diagonal. Parameters differ in scale by orders of magnitude,
+        // which a single scalar can't capture, so with a scalar most of the history went into relearning the scales.
+        for (size_t i = 0; i < direction.size(); i++)
+        {
+            direction[i] *= inverse_diagonal[i];
+        }
+
+        for (size_t pair_index = 0; pair_index < history.size(); pair_index++)
+        {
+            const auto& pair = history[pair_index];
+            const auto beta = pair.rho * dot_product(pair.gradient_change, direction);
+            for (size_t i = 0; i < direction.size(); i++)
+            {
+                direction[i] += pair.parameter_change[i] * (alphas[pair_index] - beta);
+            }
+        }
+        for (auto& value : direction)
+        {
+            value = -value;
+        }
+
+        const auto slope = dot_product(flat_gradient, direction);
+        if (!(slope < 0))
+        {
+            cout << "L-BFGS direction is not a descent direction, stopping" << endl;
+            break;
+        }
+
+        // The gradient pass at a trial step also gives the error there, so an accepted trial step costs a single pass.
+        // The trial is the step accepted last time, L-BFGS directions settle on a consistent scale after a few iterations.
+        const auto previous_error = error;
+        previous_gradient.swap(flat_gradient);
+        tune_t step = trial_step;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            trial_values[i] = values[i] + step * direction[i];
+        }
+        unflatten_parameters(trial_values, parameters);
+        error = get_gradient(flat_gradient);
+
+        // Weak Wolfe conditions: enough decrease, and the slope has flattened enough that the step isn't needlessly short
+        const bool sufficient_decrease = error <= previous_error + lbfgs_armijo_factor * step * slope;
+        const bool enough_curvature = dot_product(flat_gradient, direction) >= lbfgs_curvature_factor * slope;
+        if (!sufficient_decrease || !enough_curvature)
+        {
+            // Step lengths 1/8 to 16 times the trial step in powers of two, scaled down if none of them decreases the error enough.
+            // They are evaluated from the old parameters, the trial step's error is one of them.
+            unflatten_parameters(values, parameters);
+            unflatten_parameters(direction, direction_parameters);
+            array<tune_t, lbfgs_line_search_steps> steps;
+            tune_t base_step = step;
+            int32_t best_step_index = -1;
+            array<tune_t, lbfgs_line_search_steps> line_errors;
+            for (int32_t line_search = 0; line_search < lbfgs_max_line_searches && best_step_index < 0; line_search++)
+            {
+                for (int32_t step_index = 0; step_index < lbfgs_line_search_steps; step_index++)
+                {
+                    steps[step_index] = base_step * static_cast<tune_t>(ldexp(1.0, step_index + 1 - lbfgs_line_search_steps / 2));
+                }
+                line_errors = get_line_errors(thread_pool, entries, all_coefficients, parameters, direction_parameters, K, steps);
+                pass_count++;
+
+                for (int32_t step_index = 0; step_index < lbfgs_line_search_steps; step_index++)
+                {
+                    const bool sufficient = line_errors[step_index] <= previous_error + lbfgs_armijo_factor * steps[step_index] * slope;
+                    if (sufficient && (best_step_index < 0 || line_errors[step_index] < line_errors[best_step_index]))
+                    {
+                        best_step_index = step_index;
+                    }
+                }
+                base_step = steps[0] / 2;
+            }
+
+            if (best_step_index < 0)
+            {
+                error = previous_error;
+                flat_gradient.swap(previous_gradient);
+                cout << "L-BFGS line search found no decrease, stopping" << endl;
+                break;
+            }
+
+            // The trial step may already be the best one, its gradient is still at hand then
+            if (steps[best_step_index] != step)
+            {
+                step = steps[best_step_index];
+                for (size_t i = 0; i < values.size(); i++)
+                {
+                    trial_values[i] = values[i] + step * direction[i];
+                }
+                unflatten_parameters(trial_values, parameters);
+                error = get_gradient(flat_gradient);
+            }
+            else
+            {
+                unflatten_parameters(trial_values, parameters);
+            }
+        }
+        trial_step = step;
+
+        LbfgsPair pair;
+        pair.parameter_change = direction;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            pair.parameter_change[i] *= step;
+        }
+        values.swap(trial_values);
+
+        pair.gradient_change = flat_gradient;
+        for (size_t i = 0; i < flat_gradient.size(); i++)
+        {
+            pair.gradient_change[i] -= previous_gradient[i];
+        }
+        const auto curvature = dot_product(pair.parameter_change, pair.gradient_change);
+        if (curvature > 0)
+        {
+            pair.rho = 1 / curvature;
+            history.push_back(std::move(pair));
+            if (static_cast<int32_t>(history.size()) > lbfgs_history)
+            {
+                history.pop_front();
+            }
+        }
+
+        const auto elapsed_ms = duration_cast<milliseconds>(high_resolution_clock::now() - loop_start).count();
+        print_elapsed(start);
+        cout << "Iteration " << iteration << " (" << pass_count << " passes, " << pass_count * 1000.0 / std::max(elapsed_ms, static_cast<int64_t>(1)) << " eps), error " << error << ", step " << step << endl;
+
+        if (previous_error - error <= lbfgs_tolerance * previous_error)
+        {
+            print_elapsed(start);
+            cout << "L-BFGS converged after " << iteration << " iterations and " << pass_count << " passes" << endl;
+            break;
+        }
+    }
+
+    TuneEval::print_parameters(parameters);
+    return pass_count;
+}
+
+static atomic<bool> stop_requested = false;
+
+static void request_stop(int)
+{
+    stop_requested = true;
+    // A second signal ends the process right away
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+}
+
+// Validation error history for early stopping
+struct EarlyStopping
+{
+    tune_t best_error = numeric_limits<tune_t>::max();
+    int32_t best_epoch = 0;
+    int32_t reports_since_best = 0;
+    parameters_t best_parameters;
+};
+
+// Returns the messages to print, so the epoch loop can queue them behind its own lines
+static string save_checkpoint(const uint64_t key, const int32_t epoch, const int64_t step_count, const tune_t learning_rate, const tune_t K, const AdamState& adam, const parameters_t& parameters, const vector<int64_t>& last_steps, const vector<EntryRange>& chunks, const mt19937_64& minibatch_random, const EarlyStopping& early_stopping)
+{
+    Checkpoint::State state;
+    state.epoch = epoch;
+    state.step_count = step_count;
+    state.learning_rate = learning_rate;
+    state.K = K;
+    state.beta1_power = adam.beta1_power;
+    state.beta2_power = adam.beta2_power;
+    state.parameters = parameters;
+    state.momentum = adam.momentum;
+    state.velocity = adam.velocity;
+    state.last_steps = last_steps;
+    for (const auto& chunk : chunks)
+    {
+        state.chunk_order.push_back(chunk.begin);
+    }
+    ostringstream random_state;
+    random_state << minibatch_random;
+    state.random_state = random_state.str();
+    state.best_validation_error = early_stopping.best_error;
+    state.best_validation_epoch = early_stopping.best_epoch;
+    state.validation_reports_since_best = early_stopping.reports_since_best;
+    state.best_parameters = early_stopping.best_parameters;
+
+    ostringstream log;
+    if (Checkpoint::save(checkpoint_path, key, state, log))
+    {
+        log << "Saved checkpoint " << checkpoint_path << " after epoch " << epoch << "\n";
+    }
+    return log.str();
+}
+
+// Puts the chunks back in the saved order, which only matters for mini-batches. The layout changes with the thread count, the saved order is dropped then.
+static void restore_chunk_order(vector<EntryRange>& chunks, const vector<uint64_t>& chunk_order)
+{
+    unordered_map<uint64_t, EntryRange> chunks_by_begin;
+    for (const auto& chunk : chunks)
+    {
+        chunks_by_begin.emplace(chunk.begin, chunk);
+    }
+
+    vector<EntryRange> ordered_chunks;
+    for (const auto begin : chunk_order)
+    {
+        const auto chunk = chunks_by_begin.find(begin);
+        if (chunk == chunks_by_begin.end())
+        {
+            break;
+        }
+        ordered_chunks.push_back(chunk->second);
+    }
+
+    if (ordered_chunks.size() != chunks.size())
+    {
+        cout << "Chunk layout differs from the checkpoint, continuing with a new chunk order" << endl;
+        return;
+    }
+    chunks.swap(ordered_chunks);
+}
+
+void Tuner::run(const std::vector<DataSource>& sources)
+{
+    cout << "Starting tuning" << endl << endl;
+    const auto start = high_resolution_clock::now();
+
+    cout << "Starting thread pool..." << endl;
     ThreadPool thread_pool;
-    thread_pool.start(thread_count);
+    vector<int32_t> worker_cores;
+    if constexpr (pin_threads)
+    {
+        const auto core_count = static_cast<int32_t>(std::max(thread::hardware_concurrency(), 1U));
+        for (int32_t thread_index = 0; thread_index < thread_count; thread_index++)
+        {
+            worker_cores.push_back((pin_first_core + thread_index * pin_core_stride) % core_count);
+        }
+    }
+    thread_pool.start(thread_count, worker_cores);
 
     cout << "Getting initial parameters..." << endl;
     auto parameters = TuneEval::get_initial_parameters();
     cout << "Got " << parameters.size() << " parameters" << endl;
-    if (parameters.size() > std::numeric_limits<int16_t>::max())
+    if (static_parameter_count > 0 && parameters.size() != static_parameter_count)
+    {
+        throw runtime_error("get_initial_parameters returned " + to_string(parameters.size()) + " parameters, the eval declares " + to_string(static_parameter_count));
+    }
+    if (parameters.size() > max_coefficient_parameters)
     {
-        throw runtime_error("Parameter count exceeds int16_t limit for CoefficientEntry::index");
+        throw runtime_error("Parameter count exceeds the 24-bit limit of CoefficientEntry indices");
     }
 
     cout << "Initial parameters:" << endl;
     TuneEval::print_parameters(parameters);
 
+    // Taken before anything changes the parameters, the dataset cache key is based on the initial ones as well
+    const auto dataset_key = enable_checkpoints ? DatasetCache::get_key(sources, parameters) : 0;
+
     vector<Entry> entries;
+    vector<EntryInfo> entry_infos;
     vector<CoefficientEntry> all_coefficients;
 
     // Debug entry
@@ -878,16 +2207,75 @@ void Tuner::run(const std::vector<DataSource>& sources)
     //debug_entry.initial_eval = linear_eval(debug_entry, parameters);
     //entries.push_back(debug_entry);
 
-    vector<string> fens;
-    for (const auto& source : sources)
+    load_dataset(thread_pool, sources, parameters, start, entries, entry_infos, all_coefficients);
+    cout << "Data loading complete" << endl << endl;
+
+    print_statistics(parameters, entries, entry_infos);
+
+    constexpr bool use_validation = validation_fraction > 0;
+    vector<Entry> validation_entries;
+    vector<CoefficientEntry> validation_coefficients;
+    if constexpr (use_validation)
     {
-        load_fens(thread_pool, source, parameters, start, entries, all_coefficients);
+        split_validation_entries(entries, entry_infos, all_coefficients, validation_entries, validation_coefficients);
+        cout << "Held out " << validation_entries.size() << " positions for validation, " << entries.size() << " remain for training" << endl;
+        if (validation_entries.empty() || entries.empty())
+        {
+            throw runtime_error("Validation split left no positions on one side, change validation_fraction");
+        }
+    }
+    vector<EntryInfo>().swap(entry_infos);
+
+    if constexpr (collapse_duplicate_positions)
+    {
+        const auto collapsed_count = collapse_duplicate_entries(entries);
+        cout << "Collapsed " << collapsed_count << " duplicate positions, " << entries.size() << " weighted entries remain" << endl;
+        if constexpr (use_validation)
+        {
+            const auto collapsed_validation_count = collapse_duplicate_entries(validation_entries);
+            cout << "Collapsed " << collapsed_validation_count << " duplicate validation positions, " << validation_entries.size() << " weighted entries remain" << endl;
+        }
+    }
+    const auto total_weight = get_total_weight(entries);
+
+    if constexpr (dense_coefficient_density > 0)
+    {
+        // Chosen from the training entries alone, validation entries get the same layout so the kernels can read both
+        const auto layout = choose_dense_coefficients(entries, all_coefficients, parameters.size(), dense_coefficient_density);
+        split_dense_coefficients(entries, all_coefficients, layout);
+        if constexpr (use_validation)
+        {
+            split_dense_coefficients(validation_entries, validation_coefficients, layout);
+        }
+        dense_coefficients = layout;
+        print_elapsed(start);
+        cout << "Moved " << layout.parameter_indices.size() << " parameters into dense blocks of " << layout.width << " codes per position" << endl;
+    }
+    cout << "Coefficients take " << all_coefficients.size() * sizeof(CoefficientEntry) / (1024.0 * 1024.0) << " MB" << (compress_coefficients ? " compressed" : "") << endl;
+
+    if constexpr (place_dataset_per_worker)
+    {
+        place_dataset_on_workers(thread_pool, entries, all_coefficients);
+        print_elapsed(start);
+        cout << "Placed dataset in worker-local memory" << endl;
     }
-    cout << "Data loading complete" << endl << endl;
 
-    print_statistics(parameters, entries);
+    uint64_t checkpoint_key = 0;
+    Checkpoint::State checkpoint;
+    bool resumed = false;
+    if constexpr (enable_checkpoints)
+    {
+        checkpoint_key = Checkpoint::get_key(dataset_key, entries.size());
+        resumed = Checkpoint::load(checkpoint_path, checkpoint_key, checkpoint);
+        if (resumed)
+        {
+            parameters = checkpoint.parameters;
+            print_elapsed(start);
+            cout << "Resuming from checkpoint " << checkpoint_path << " after epoch " << checkpoint.epoch << endl;
+        }
+    }
 
-    if constexpr (TuneEval::retune_from_zero)
+    if (TuneEval::retune_from_zero && !resumed)
     {
         for (auto& parameter : parameters)
         {
@@ -900,13 +2288,31 @@ void Tuner::run(const std::vector<DataSource>& sources)
         }
     }
 
+    const CoefficientEntry* all_coeff_ptr = all_coefficients.data();
+
+    if (least_squares_warm_start && !resumed)
+    {
+        // Only the product of K and the eval scale matters for the fit, so without a preferred K the usual starting guess sets the scale
+        const tune_t warm_start_k = TuneEval::preferred_k > 0 ? TuneEval::preferred_k : 2.5;
+        warm_start_parameters(thread_pool, entries, all_coeff_ptr, parameters, warm_start_k);
+        print_elapsed(start);
+        cout << "Warm started parameters with least squares" << endl;
+    }
+
     cout << "Initial parameters:" << endl;
     TuneEval::print_parameters(parameters);
 
-    const CoefficientEntry* all_coeff_ptr = all_coefficients.data();
+    const auto coefficient_encoding = coefficient_values.get_encoding();
+    const auto kernel_isa = enable_simd_kernels && coefficient_encoding != CoefficientEncoding::Escaped ? detect_kernel_isa() : KernelIsa::Scalar;
+    const auto gradient_kernel = get_gradient_kernel(kernel_isa, coefficient_encoding);
+    cout << "Using " << get_kernel_isa_name(kernel_isa) << " gradient kernel with " << get_coefficient_encoding_name(coefficient_encoding) << " coefficient values" << endl;
 
     tune_t K;
-    if constexpr (TuneEval::preferred_k <= 0)
+    if (resumed)
+    {
+        K = checkpoint.K;
+    }
+    else if constexpr (TuneEval::preferred_k <= 0)
     {
         cout << "Finding optimal K..." << endl;
         K = find_optimal_k(thread_pool, entries, all_coeff_ptr, parameters);
@@ -920,89 +2326,245 @@ void Tuner::run(const std::vector<DataSource>& sources)
 
     const auto avg_error = get_average_error(thread_pool, entries, all_coeff_ptr, parameters, K);
     cout << "Initial error = " << avg_error << endl;
+    if constexpr (use_validation)
+    {
+        cout << "Initial validation error = " << get_average_error(thread_pool, validation_entries, validation_coefficients.data(), parameters, K) << endl;
+    }
 
     const auto loop_start = high_resolution_clock::now();
     tune_t learning_rate = TuneEval::initial_learning_rate;
     int32_t max_tune_epoch = TuneEval::max_epoch;
 
     // Pre-allocate all gradient storage once
+    AdamState adam;
 #if TAPERED
-    parameters_t momentum(parameters.size(), pair_t{});
-    parameters_t velocity(parameters.size(), pair_t{});
+    adam.momentum.resize(parameters.size(), pair_t{});
+    adam.velocity.resize(parameters.size(), pair_t{});
     parameters_t gradient(parameters.size(), pair_t{});
-    array<parameters_t, thread_count> thread_gradients;
-    for (auto& tg : thread_gradients) tg = parameters_t(parameters.size(), pair_t{});
 #else
-    parameters_t momentum(parameters.size(), 0);
-    parameters_t velocity(parameters.size(), 0);
+    adam.momentum.resize(parameters.size(), 0);
+    adam.velocity.resize(parameters.size(), 0);
     parameters_t gradient(parameters.size(), 0);
-    array<parameters_t, thread_count> thread_gradients;
-    for (auto& tg : thread_gradients) tg = parameters_t(parameters.size(), 0);
 #endif
 
-    constexpr tune_t beta1 = 0.9;
-    constexpr tune_t beta2 = 0.999;
-    tune_t beta1_power = 1.0;
-    tune_t beta2_power = 1.0;
+    // Full batch epochs take one step over chunks balanced across the threads.
+    // Mini-batch epochs step through blocks of entries in a new random order every pass, several blocks per step.
+    constexpr bool use_minibatches = minibatch_size > 0;
+    const auto chunk_size = use_minibatches ? get_minibatch_block_size() : get_entry_chunk_size(entries.size());
+    auto chunks = get_entry_ranges(entries, chunk_size);
+    const auto chunks_per_step = use_minibatches ? std::max(static_cast<size_t>(minibatch_size) / chunk_size, static_cast<size_t>(1)) : chunks.size();
+    mt19937_64 minibatch_random(minibatch_seed);
+    if constexpr (use_minibatches)
+    {
+        cout << "Using mini-batches of " << chunks_per_step * chunk_size << " positions in blocks of " << chunk_size << endl;
+    }
 
-    for (int32_t epoch = 1; epoch < max_tune_epoch; epoch++)
+    GradientWorkspace gradient_workspace;
+    gradient_workspace.kernel = gradient_kernel;
+    gradient_workspace.resize(parameters.size(), std::min(chunks_per_step, chunks.size()));
+    if constexpr (column_major_gradient)
     {
-        // Zero gradient without reallocating
-#if TAPERED
-        std::fill(gradient.begin(), gradient.end(), pair_t{});
-#else
-        std::fill(gradient.begin(), gradient.end(), static_cast<tune_t>(0));
-#endif
-        
-        compute_gradient(thread_pool, gradient, thread_gradients, entries, all_coeff_ptr, parameters, K);
+        gradient_workspace.columns.build(entries, all_coefficients, parameters.size());
+        gradient_workspace.residuals.resize(entries.size());
+        print_elapsed(start);
+        cout << "Built column index with " << gradient_workspace.columns.values.size() << " coefficients" << endl;
+    }
+    vector<int64_t> last_steps(sparse_adam ? parameters.size() : 0, 0);
+
+    int32_t first_epoch = 1;
+    int64_t step_count = 0;
+    EarlyStopping early_stopping;
+    if (resumed)
+    {
+        first_epoch = checkpoint.epoch + 1;
+        step_count = checkpoint.step_count;
+        learning_rate = checkpoint.learning_rate;
+        adam.beta1_power = checkpoint.beta1_power;
+        adam.beta2_power = checkpoint.beta2_power;
+        adam.momentum = checkpoint.momentum;
+        adam.velocity = checkpoint.velocity;
+        if (checkpoint.last_steps.size() == last_steps.size())
+        {
+            last_steps = checkpoint.last_steps;
+        }
+        if (!checkpoint.best_parameters.empty())
+        {
+            early_stopping.best_error = checkpoint.best_validation_error;
+            early_stopping.best_epoch = checkpoint.best_validation_epoch;
+            early_stopping.reports_since_best = checkpoint.validation_reports_since_best;
+            early_stopping.best_parameters = checkpoint.best_parameters;
+        }
+        if constexpr (use_minibatches)
+        {
+            restore_chunk_order(chunks, checkpoint.chunk_order);
+            istringstream random_state(checkpoint.random_state);
+            random_state >> minibatch_random;
+        }
+    }
+
+    if constexpr (enable_checkpoints)
+    {
+        signal(SIGINT, request_stop);
+        signal(SIGTERM, request_stop);
+    }
+
+    // L-BFGS takes a gradient and a line search pass per iteration instead of an epoch per step, epochs count data passes for both
+    int32_t finished_epochs = std::max(max_tune_epoch - first_epoch, 0);
+    if constexpr (use_lbfgs)
+    {
+        finished_epochs = run_lbfgs(thread_pool, gradient_workspace, chunks, entries, all_coeff_ptr, parameters, K, total_weight, start);
+    }
+
+    // Parameters are printed off the epoch loop's thread, the next epoch starts while they are formatted
+    ParameterReporter reporter;
+    if constexpr (!use_lbfgs)
+    {
+        reporter.start();
+    }
 
-        beta1_power *= beta1;
-        beta2_power *= beta2;
-        tune_t bias_correction1 = 1;
-        tune_t bias_correction2 = 1;
-        if constexpr (TuneEval::adam_bias_correction)
+    bool stopped_early = false;
+    bool interrupted = false;
+    for (int32_t epoch = first_epoch; epoch < max_tune_epoch && !use_lbfgs; epoch++)
+    {
+        if constexpr (use_minibatches)
         {
-            bias_correction1 = 1 - beta1_power;
-            bias_correction2 = 1 - beta2_power;
+            shuffle(chunks.begin(), chunks.end(), minibatch_random);
         }
 
-        for (int parameter_index = 0; parameter_index < parameters.size(); parameter_index++) {
-#if TAPERED
-            for(int phase_stage = 0; phase_stage < 2; phase_stage++)
-            {
-                const tune_t grad = -K / static_cast<tune_t>(400) * gradient[parameter_index][phase_stage] / static_cast<tune_t>(entries.size());
-                momentum[parameter_index][phase_stage] = beta1 * momentum[parameter_index][phase_stage] + (1 - beta1) * grad;
-                velocity[parameter_index][phase_stage] = beta2 * velocity[parameter_index][phase_stage] + (1 - beta2) * grad * grad;
-                const tune_t corrected_momentum = momentum[parameter_index][phase_stage] / bias_correction1;
-                const tune_t corrected_velocity = velocity[parameter_index][phase_stage] / bias_correction2;
-                parameters[parameter_index][phase_stage] -= learning_rate * corrected_momentum / (static_cast<tune_t>(1e-8) + sqrt(corrected_velocity));
+        // The epoch's error comes from its gradient passes, so it belongs to the parameters before each step's update.
+        // The validation error is measured on the parameters the epoch starts from, which a full batch epoch's error describes too,
+        // and early stopping keeps those parameters. Only the validation entries are scanned again.
+        const bool report = epoch % error_print_interval == 0;
+        tune_t validation_error = 0;
+        bool early_stop = false;
+        if (use_validation && report)
+        {
+            validation_error = get_average_error(thread_pool, validation_entries, validation_coefficients.data(), parameters, K);
+
+            // Tiny improvements on a plateau don't count, they would keep the run going for thousands of epochs
+            if (validation_error < early_stopping.best_error * (1 - validation_min_improvement))
+            {
+                early_stopping.best_error = validation_error;
+                early_stopping.best_epoch = epoch;
+                early_stopping.best_parameters = parameters;
+                early_stopping.reports_since_best = 0;
+            }
+            else
+            {
+                early_stopping.reports_since_best++;
+                early_stop = validation_patience > 0 && early_stopping.reports_since_best >= validation_patience;
             }
-#else
-            const tune_t grad = -K / 400.0 * gradient[parameter_index] / static_cast<tune_t>(entries.size());
-            momentum[parameter_index] = beta1 * momentum[parameter_index] + (1 - beta1) * grad;
-            velocity[parameter_index] = beta2 * velocity[parameter_index] + (1 - beta2) * grad * grad;
-            const tune_t corrected_momentum = momentum[parameter_index] / bias_correction1;
-            const tune_t corrected_velocity = velocity[parameter_index] / bias_correction2;
-            parameters[parameter_index] -= learning_rate * corrected_momentum / (1e-8 + sqrt(corrected_velocity));
-#endif
-            
         }
 
-        if (epoch % 100 == 0)
+        PairwiseSum<tune_t> epoch_error;
+        for (size_t step_start = 0; step_start < chunks.size(); step_start += chunks_per_step)
+        {
+            const auto step_chunk_count = std::min(chunks_per_step, chunks.size() - step_start);
+            int64_t step_weight = 0;
+            for (size_t chunk_index = step_start; chunk_index < step_start + step_chunk_count; chunk_index++)
+            {
+                step_weight += chunks[chunk_index].weight;
+            }
+
+            step_count++;
+            if constexpr (sparse_adam)
+            {
+                epoch_error.add(compute_sparse_gradient(thread_pool, gradient_workspace, gradient, chunks.data() + step_start, step_chunk_count, entries, all_coeff_ptr, parameters, K));
+                sparse_adam_step(adam, last_steps, step_count, parameters, gradient, gradient_workspace.touched, step_weight, K, learning_rate);
+            }
+            else
+            {
+                zero_gradient(gradient);
+                epoch_error.add(compute_gradient(thread_pool, gradient_workspace, gradient, chunks.data() + step_start, step_chunk_count, entries, all_coeff_ptr, parameters, K));
+                adam_step(adam, parameters, gradient, step_weight, K, learning_rate);
+            }
+        }
+        const tune_t error = epoch_error.get() / static_cast<tune_t>(total_weight);
+
+        // Lines of the loop go through the reporter, so they never wait for a report that is being printed
+        if (report)
         {
             const auto elapsed_ms = duration_cast<milliseconds>(high_resolution_clock::now() - loop_start).count();
-            const auto epochs_per_second = epoch * 1000.0 / elapsed_ms;
-            const tune_t error = get_average_error(thread_pool, entries, all_coeff_ptr, parameters, K);
-            print_elapsed(start);
-            cout << "Epoch " << epoch << " (" << epochs_per_second << " eps), error " << error << ", LR " << learning_rate << endl;
-            TuneEval::print_parameters(parameters);
+            const auto epochs_per_second = (epoch - first_epoch + 1) * 1000.0 / elapsed_ms;
+            ostringstream line;
+            print_elapsed(start, line);
+            line << "Epoch " << epoch << " (" << epochs_per_second << " eps), error " << error << ", LR " << learning_rate;
+            if constexpr (use_minibatches)
+            {
+                line << ", " << step_count << " steps";
+            }
+            if constexpr (use_validation)
+            {
+                line << ", validation error " << validation_error;
+            }
+            line << "\n";
+            reporter.print(line.str());
+        }
+
+        if (epoch % 100 == 0)
+        {
+            reporter.publish(parameters, epoch, error);
         }
 
         if(epoch % TuneEval::learning_rate_drop_interval == 0)
         {
             learning_rate *= TuneEval::learning_rate_drop_ratio;
         }
+
+        // A stop request finishes the running epoch first, so the checkpoint holds a consistent state
+        const bool stopping = stop_requested;
+        if constexpr (enable_checkpoints)
+        {
+            if (epoch % checkpoint_interval == 0 || stopping)
+            {
+                reporter.print(save_checkpoint(checkpoint_key, epoch, step_count, learning_rate, K, adam, parameters, last_steps, chunks, minibatch_random, early_stopping));
+            }
+        }
+        if (stopping)
+        {
+            finished_epochs = epoch - first_epoch + 1;
+            interrupted = true;
+            ostringstream line;
+            print_elapsed(start, line);
+            line << "Stopped after epoch " << epoch << ", start again to resume from the checkpoint\n";
+            reporter.print(line.str());
+            break;
+        }
+
+        if (early_stop)
+        {
+            finished_epochs = epoch - first_epoch + 1;
+            stopped_early = true;
+            parameters = early_stopping.best_parameters;
+            break;
+        }
+    }
+
+    const auto loop_elapsed_ms = duration_cast<milliseconds>(high_resolution_clock::now() - loop_start).count();
+    reporter.stop();
+    if (stopped_early)
+    {
+        // Printed after the reporter is done, so a pending snapshot of a later epoch doesn't follow the kept parameters
+        print_elapsed(start);
+        cout << "Validation error did not improve for " << validation_patience << " reports, stopping after epoch " << first_epoch + finished_epochs - 1
+            << " with the parameters of epoch " << early_stopping.best_epoch << ", validation error " << early_stopping.best_error << endl;
+        TuneEval::print_parameters(parameters);
+    }
+    if constexpr (enable_checkpoints)
+    {
+        if (!interrupted)
+        {
+            Checkpoint::remove(checkpoint_path);
+        }
     }
+    const tune_t final_error = get_average_error(thread_pool, entries, all_coeff_ptr, parameters, K);
+    print_elapsed(start);
+    cout << "Finished " << finished_epochs << " epochs (" << finished_epochs * 1000.0 / loop_elapsed_ms << " eps), final error " << setprecision(10) << final_error;
+    if constexpr (use_validation)
+    {
+        cout << ", validation error " << get_average_error(thread_pool, validation_entries, validation_coefficients.data(), parameters, K);
+    }
+    cout << endl;
 
     thread_pool.stop();
 }
\ No newline at end of file